@@ -0,0 +1,126 @@
+#include <vector>
+#include <cstdlib>
+#include <new>
+#ifdef __linux__
+#    include <sys/mman.h>
+#endif
+#include "arena.h"
+#include "mp.h"
+
+namespace Arena {
+    /*sizes of classes grow geometrically with SUB classes per doubling*/
+    const size_t SUB = 8;
+    const size_t LOG_SUB = 3;
+    const size_t CLASSES = SUB * (sizeof(size_t) * 8 + 1);
+
+    /*a block is preceded by its size and the offset to its allocation*/
+    struct Header {
+        size_t size;
+        size_t front;
+    };
+
+    static std::vector<char*> free_list[CLASSES];
+    static bool   huge = false;
+    static size_t in_use = 0, peak = 0, cached = 0;
+    static Int    n_fresh = 0, n_reused = 0;
+
+    /** Position of the highest set bit */
+    static inline size_t log2i(size_t n) {
+#if defined(__GNUC__)
+        return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(n);
+#else
+        size_t b = 0;
+        while(n >>= 1) b++;
+        return b;
+#endif
+    }
+    /** Smallest class holding n units of ALIGN bytes */
+    static inline size_t size_class(size_t n) {
+        if(n <= SUB)
+            return n;
+        size_t o = log2i(n - 1) - LOG_SUB;
+        return SUB * o + ((n - 1) >> o) + 1;
+    }
+    /** Units of ALIGN bytes in a class */
+    static inline size_t class_units(size_t k) {
+        if(k <= SUB)
+            return k;
+        size_t o = (k - 1) / SUB - 1;
+        return (k - SUB * o) << o;
+    }
+    static inline Header* header(char* p) {
+        return (Header*)(p - ALIGN);
+    }
+}
+
+/** Use transparent huge pages for large blocks */
+void Arena::init(bool huge_pages) {
+    huge = huge_pages;
+}
+/**
+Get a block of at least the given number of bytes. Fresh is set when
+the block comes from the system and has not been touched yet.
+*/
+void* Arena::alloc(size_t bytes,bool* fresh) {
+    size_t k = size_class((bytes + ALIGN - 1) / ALIGN);
+    size_t sz = class_units(k) * ALIGN;
+    char* p;
+    std::vector<char*>& fl = free_list[k];
+    if(!fl.empty()) {
+        p = fl.back();
+        fl.pop_back();
+        cached -= sz;
+        n_reused++;
+        if(fresh) *fresh = false;
+    } else {
+        /*large blocks start on a huge page, with the header alone
+          on the small page in front of it*/
+        bool large = huge && (sz >= HUGE_PAGE);
+        size_t front = large ? HUGE_PAGE : ALIGN;
+        void* v;
+        if(posix_memalign(&v,front,sz + front))
+            throw std::bad_alloc();
+        p = (char*)v + front;
+#ifdef MADV_HUGEPAGE
+        if(large)
+            madvise(p,sz,MADV_HUGEPAGE);
+#endif
+        header(p)->size = sz;
+        header(p)->front = front;
+        n_fresh++;
+        if(fresh) *fresh = true;
+    }
+    in_use += sz;
+    if(in_use > peak) peak = in_use;
+    return p;
+}
+/** Put block back in the free list of its class, or return it to the system */
+void Arena::free(void* q,bool cache) {
+    if(!q) return;
+    char* p = (char*)q;
+    size_t sz = header(p)->size;
+    in_use -= sz;
+    if(cache) {
+        free_list[size_class(sz / ALIGN)].push_back(p);
+        cached += sz;
+    } else {
+        ::free(p - header(p)->front);
+    }
+}
+/** Return all cached blocks to the system */
+void Arena::release() {
+    for(size_t k = 0;k < CLASSES;k++) {
+        std::vector<char*>& fl = free_list[k];
+        for(Int i = 0;i < fl.size();i++)
+            ::free(fl[i] - header(fl[i])->front);
+        std::vector<char*>().swap(fl);
+    }
+    cached = 0;
+}
+/** Print memory usage of fields */
+void Arena::report() {
+    const double MB = 1024.0 * 1024.0;
+    MP::printH("Field memory: peak %.1f MB, in use %.1f MB, cached %.1f MB, "
+        "%d blocks allocated, %d reused\n",
+        peak / MB, in_use / MB, cached / MB, int(n_fresh), int(n_reused));
+}
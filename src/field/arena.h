@@ -0,0 +1,26 @@
+#ifndef __ARENA_H
+#define __ARENA_H
+
+#include <cstddef>
+#include "my_types.h"
+
+/**
+Memory of fields. Blocks are aligned to cache lines and rounded up to
+geometric size classes, eight per doubling. Released blocks are kept in
+a free list per class, so that temporaries reuse a block instead of
+going to the system allocator. With huge pages, large blocks start on a
+huge page boundary. Cached blocks are returned to the system when the
+mesh changes.
+*/
+namespace Arena {
+    const size_t ALIGN = 64;                /**< Alignment of blocks */
+    const size_t HUGE_PAGE = 2 * 1024 * 1024; /**< Size of a huge page */
+
+    void  init(bool huge_pages);
+    void* alloc(size_t bytes,bool* fresh = 0);
+    void  free(void* p,bool cache = true);
+    void  release();
+    void  report();
+}
+
+#endif
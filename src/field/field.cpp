@@ -18,9 +18,22 @@ namespace Mesh {
     ScalarCellField   yWall(false);
     IntVector         FO;
     IntVector         FN;
+    IntVector         gFaceGroups;
+    IntVector         gGroupStart;
+    IntVector         gColorStart;
+    IntVector         gGroupColor;
+    bool              gFaceColored = false;
+    bool              gEarlySend = false;
+    IntVector         gFaceRuns;
+    IntVector         gGroupRuns;
+    IntVector         gGroupRun;
+    std::vector<FaceStencil> gStencil;
+    Compressed        gCellFaces;
+    Compressed        gFaceVertices;
     IntVector  probeCells;
     Int         gBCSfield;
     Int         gBCSIfield;
+    Int         gHCSfield;
     Int         gBFSfield;
     
     Vertices                 probePoints;
@@ -36,6 +49,7 @@ Refinement and domain decomposition parameters
 namespace Controls {
     RefineParams refine_params;
     DecomposeParams decompose_params;
+    RenumberParams renumber_params;
 }
 
 /**
@@ -64,6 +78,10 @@ namespace Controls {
     Int save_average = 0;
     Int print_time = 0;
     CommMethod parallel_method = BLOCKED;
+    Int reduced_halo = 0;
+    Int n_threads = 1;
+    Int huge_pages = 0;
+    Int packed_faces = 0;
     Vector gravity = Vector(0,0,-9.860616);
 }
 /**
@@ -116,7 +134,8 @@ bool Mesh::LoadMesh(Int step_, bool first, bool remove_empty) {
         /*erase interior and empty boundaries*/
         for(Boundaries::iterator it = gBoundaries.begin();
                     it != gBoundaries.end();) {
-            if(it->second.size() <= 0 || 
+            if((it->second.size() <= 0 && 
+                it->first.find("interMesh") == std::string::npos) || 
                 it->first.find("interior") != std::string::npos
                 ) {
                     gBoundaries.erase(it++);
@@ -125,6 +144,14 @@ bool Mesh::LoadMesh(Int step_, bool first, bool remove_empty) {
         /*geometric mesh fields*/
         remove_fields();
         initGeomMeshFields();
+        /*geometry now lives in cC,cV,fC,fN and connectivity in
+          gCellFaces,gFaceVertices; only prepare steps that edit the 
+          mesh still need the raw copies*/
+        if(remove_empty) {
+            gMesh.clearGeometry();
+            Cells().swap(gCells);
+            Facets().swap(gFacets);
+        }
         if(MP::printOn) 
             cout << "--------------------------------------------\n";
         return true;
@@ -137,8 +164,11 @@ bool Mesh::LoadMesh(Int step_, bool first, bool remove_empty) {
 void Mesh::initGeomMeshFields() {
     FO = gFOC;
     FN = gFNC;
+    gCellFaces.compress(gCells);
+    gFaceVertices.compress(gFacets);
     gBCSfield = gBCS * DG::NP;
     gBCSIfield = gBCSI * DG::NP;
+    gHCSfield = gHCS * DG::NP;
     /* Allocate fields*/
     vC.deallocate(false);
     vC.allocate(gVertices);
@@ -171,6 +201,8 @@ void Mesh::initGeomMeshFields() {
         DG::expand(fI);
         DG::init_basis();
     }
+    groupFaces();
+    findFaceRuns();
     /*Start communicating cV and cC*/
     ASYNC_COMM<Scalar> commv(&cV[0]);
     ASYNC_COMM<Vector> commc(&cC[0]);
@@ -194,7 +226,7 @@ void Mesh::initGeomMeshFields() {
             Int k = faceid * DG::NPF + n;
             Int c1 = FO[k];
             Int c2 = FN[k];
-            if(c2 >= gBCSfield && !isGhostFace[faceid]) {
+            if(c2 >= gHCSfield && !isGhostFace[faceid]) {
                 fI[k] = 0;
                 cV[c2] = cV[c1];
                 cC[c2] = fC[k];
@@ -265,6 +297,8 @@ void Mesh::initGeomMeshFields() {
             }
         }
     }
+    /*packed face stencils*/
+    packFaces();
     /*Construct wall distance field*/
     {
         yWall.deallocate(false);
@@ -291,6 +325,181 @@ void Mesh::initGeomMeshFields() {
     }
 }
 /**
+Group faces into contiguous ranges: interior faces away from halo and
+boundary cells, the remaining interior faces, processor faces and then
+physical boundary faces patch by patch. When threaded, faces of each
+group are also colored so that no two faces of a color share a cell, and
+face loops that scatter to cells run in parallel color by color.
+*/
+void Mesh::groupFaces() {
+    using namespace DG;
+    const Int nf = FN.size();
+    /*group of each face*/
+    IntVector group(nf);
+    forEach(FN,f) {
+        if(FN[f] < gBCSIfield) group[f] = INNER_FACES;
+        else if(FN[f] < gBCSfield) group[f] = INTERIOR_FACES;
+        else group[f] = PROCESSOR_FACES;
+    }
+    Int ngroups = BOUNDARY_FACES;
+    forEachIt(Boundaries,gBoundaries,it) {
+        if(it->first.find("interMesh") != std::string::npos)
+            continue;
+        const IntVector& fs = it->second;
+        forEach(fs,j) {
+            for(Int n = 0; n < NPF;n++) {
+                Int k = fs[j] * NPF + n;
+                if(FN[k] >= gBCSfield)
+                    group[k] = ngroups;
+            }
+        }
+        ngroups++;
+    }
+    /*bucket faces by group keeping their order*/
+    gGroupStart.assign(ngroups + 1,0);
+    forEach(FN,f)
+        gGroupStart[group[f] + 1]++;
+    for(Int g = 0;g < ngroups;g++)
+        gGroupStart[g + 1] += gGroupStart[g];
+    gFaceGroups.resize(nf);
+    {
+        IntVector pos(gGroupStart.begin(),gGroupStart.end() - 1);
+        forEach(FN,f)
+            gFaceGroups[pos[group[f]]++] = f;
+    }
+    /*a single color per group when serial*/
+    gColorStart = gGroupStart;
+    gGroupColor.resize(ngroups + 1);
+    for(Int g = 0;g <= ngroups;g++)
+        gGroupColor[g] = g;
+    gFaceColored = false;
+    /*values sent to neighbors all come from cells next to the halo,
+      unless the halo is more than one layer deep*/
+    gEarlySend = true;
+    forEach(gInterMesh,i) {
+        const IntVector& sc = gInterMesh[i].sc;
+        forEach(sc,j) {
+            if(sc[j] < gBCSIfield)
+                gEarlySend = false;
+        }
+    }
+    if(Threads::n_threads <= 1)
+        return;
+    /*greedy coloring with a bit mask of used colors per cell*/
+    const Int MAX_COLORS = sizeof(Int) * 8;
+    Int nc = 0;
+    forEach(FO,f) {
+        if(FO[f] + 1 > nc) nc = FO[f] + 1;
+        if(FN[f] + 1 > nc) nc = FN[f] + 1;
+    }
+    IntVector used(nc,0),color(nf),faces(nf);
+    IntVector colorStart(1,0),groupColor(ngroups + 1);
+    for(Int g = 0;g < ngroups;g++) {
+        const Int s = gGroupStart[g], e = gGroupStart[g + 1];
+        IntVector count(MAX_COLORS + 1,0);
+        for(Int j = s;j < e;j++) {
+            Int f = gFaceGroups[j];
+            Int mask = used[FO[f]] | used[FN[f]];
+            Int c = 0;
+            while(c < MAX_COLORS && (mask & (Int(1) << c))) c++;
+            if(c == MAX_COLORS) {
+                if(MP::printOn)
+                    cout << "Face coloring failed: face loops run serially\n";
+                return;
+            }
+            used[FO[f]] |= (Int(1) << c);
+            used[FN[f]] |= (Int(1) << c);
+            color[j] = c;
+            count[c + 1]++;
+        }
+        for(Int j = s;j < e;j++) {
+            Int f = gFaceGroups[j];
+            used[FO[f]] = used[FN[f]] = 0;
+        }
+        /*bucket faces of the group by color keeping their order*/
+        Int ncolors = 0;
+        for(Int c = 0;c < MAX_COLORS;c++) {
+            if(count[c + 1]) ncolors = c + 1;
+            count[c + 1] += count[c];
+        }
+        groupColor[g] = colorStart.size() - 1;
+        for(Int c = 0;c < ncolors;c++)
+            colorStart.push_back(s + count[c + 1]);
+        for(Int j = s;j < e;j++)
+            faces[s + count[color[j]]++] = gFaceGroups[j];
+    }
+    groupColor[ngroups] = colorStart.size() - 1;
+    gFaceGroups.swap(faces);
+    gColorStart.swap(colorStart);
+    gGroupColor.swap(groupColor);
+    gFaceColored = true;
+}
+/**
+Split segments [segStart[g],segStart[g+1]) of a face list into runs
+*/
+static void findRuns(const IntVector* list,const IntVector& segStart,
+                     IntVector& runStart,IntVector& segRun) {
+    using namespace Mesh;
+    runStart.clear();
+    segRun.resize(segStart.size());
+    for(Int g = 0;g + 1 < segStart.size();g++) {
+        segRun[g] = runStart.size();
+        Int pf = 0;
+        for(Int j = segStart[g];j < segStart[g + 1];j++) {
+            Int f = list ? (*list)[j] : j;
+            if(j == segStart[g] || f != pf + 1 ||
+               FO[f] != FO[pf] + 1 || FN[f] != FN[pf] + 1)
+                runStart.push_back(j);
+            pf = f;
+        }
+    }
+    segRun.back() = runStart.size();
+    runStart.push_back(segStart.back());
+}
+/**
+Find runs of consecutive faces whose owners and neighbors are consecutive
+too, as in the i-j-k blocks of hexMesh. Face loops over a run address
+cells directly instead of through FO/FN. Runs are used only when face
+loops run serially and the mesh is mostly structured; elsewhere, e.g. at
+block interfaces and refined regions, runs have a single face.
+*/
+void Mesh::findFaceRuns() {
+    const Int MIN_LENGTH = 4;
+    IntVector().swap(gFaceRuns);
+    IntVector().swap(gGroupRuns);
+    IntVector().swap(gGroupRun);
+    if(gFaceColored || FN.empty())
+        return;
+    IntVector all(2,0),allRun;
+    all[1] = FN.size();
+    findRuns(0,all,gFaceRuns,allRun);
+    const Int nruns = gFaceRuns.size() - 1;
+    if(FN.size() < MIN_LENGTH * nruns) {
+        IntVector().swap(gFaceRuns);
+        return;
+    }
+    findRuns(&gFaceGroups,gGroupStart,gGroupRuns,gGroupRun);
+    MP::printH("\t%d face runs of average length %.1f\n",
+        int(nruns),double(FN.size()) / nruns);
+}
+/**
+Pack face indices and geometry into one record per face
+*/
+void Mesh::packFaces() {
+    std::vector<FaceStencil>().swap(gStencil);
+    if(!Controls::packed_faces)
+        return;
+    gStencil.resize(FN.size());
+    forEach(gStencil,f) {
+        FaceStencil& s = gStencil[f];
+        s.o = FO[f];
+        s.n = FN[f];
+        s.fI = fI[f];
+        s.fD = fD[f];
+        s.fN = fN[f];
+    }
+}
+/**
 Find nearest cell
 */
 Int Mesh::findNearestCell(const Vector& v) {
@@ -381,6 +590,7 @@ void Mesh::remove_fields() {
     forEachFacetField(removeAll());
     forEachVertexField(removeAll());
     BaseField::allFields.clear();
+    Arena::release();
 }
 /**
 Enroll refine parameters
@@ -398,10 +608,20 @@ Enroll domain decomposition parameters
 void Controls::enrollDecompose(Util::ParamList& params) {
     params.enroll("n",&decompose_params.n);
     params.enroll("axis",&decompose_params.axis);
+    params.enroll("ghost_depth",&decompose_params.ghost_depth);
+    params.enroll("group_size",&decompose_params.group_size);
     Util::Option* op = new Util::Option(&decompose_params.type, 4, 
             "XYZ","CELLID","METIS","NONE");
     params.enroll("type",op);
 }
+/**
+Enroll renumbering parameters
+*/
+void Controls::enrollRenumber(Util::ParamList& params) {
+    Util::Option* op = new Util::Option(&renumber_params.type, 2, 
+            "RCM","SFC");
+    params.enroll("type",op);
+}
 /**
  Enroll solver control parameters
 */
@@ -415,6 +635,7 @@ void Mesh::enroll(Util::ParamList& params) {
     params.enroll("end_step",&end_step);
     params.enroll("amr_step",&amr_step);
     params.enroll("n_deferred",&n_deferred);
+    params.enroll("threads",&n_threads);
 
     params.enroll("blend_factor",&blend_factor);
     params.enroll("tolerance",&tolerance);
@@ -447,6 +668,12 @@ void Mesh::enroll(Util::ParamList& params) {
     params.enroll("state",op);
     op = new Option(&parallel_method,2,"BLOCKED","ASYNCHRONOUS");
     params.enroll("parallel_method",op);
+    op = new Util::BoolOption(&reduced_halo);
+    params.enroll("reduced_halo",op);
+    op = new Util::BoolOption(&huge_pages);
+    params.enroll("huge_pages",op);
+    op = new Util::BoolOption(&packed_faces);
+    params.enroll("packed_faces",op);
     op = new Util::BoolOption(&save_average);
     params.enroll("average",op);
     params.enroll("print_time",&print_time);
@@ -659,6 +886,225 @@ void Prepare::refineMesh(Int step,bool init_threshold) {
     BaseField::destroyFields();
 }
 
+/*********************************
+ *
+ * Cell and face renumbering
+ *
+ *********************************/
+namespace Prepare {
+
+/**
+Breadth first search visiting neighbors by increasing degree
+*/
+static void cuthillMcKee(Int start,const IntVector& xadj,const IntVector& adj,
+                         IntVector& visited,Int mark,IntVector& level,IntVector& out) {
+    Int head = out.size();
+    out.push_back(start);
+    visited[start] = mark;
+    level[start] = 0;
+    while(head < out.size()) {
+        Int ci = out[head++];
+        std::vector< std::pair<Int,Int> > nbrs;
+        for(Int j = xadj[ci];j < xadj[ci + 1];j++) {
+            Int n = adj[j];
+            if(visited[n] != mark) {
+                visited[n] = mark;
+                level[n] = level[ci] + 1;
+                nbrs.push_back(std::make_pair(xadj[n + 1] - xadj[n],n));
+            }
+        }
+        std::sort(nbrs.begin(),nbrs.end());
+        forEach(nbrs,j)
+            out.push_back(nbrs[j].second);
+    }
+}
+/**
+Reverse Cuthill-McKee ordering of internal cells
+*/
+void orderRCM(IntVector& order) {
+    using namespace Mesh;
+    
+    /*adjacency*/
+    IntVector xadj,adj;
+    for(Int i = 0;i < gBCS;i++) {
+        Cell& c = gCells[i];
+        xadj.push_back(adj.size());
+        forEach(c,j) {
+            Int f = c[j];
+            Int n = (gFOC[f] == i) ? gFNC[f] : gFOC[f];
+            if(n < gBCS)
+                adj.push_back(n);
+        }
+    }
+    xadj.push_back(adj.size());
+    
+    /*cells by increasing degree*/
+    std::vector< std::pair<Int,Int> > byDegree(gBCS);
+    for(Int i = 0;i < gBCS;i++)
+        byDegree[i] = std::make_pair(xadj[i + 1] - xadj[i],i);
+    std::sort(byDegree.begin(),byDegree.end());
+    
+    /*each connected component is started from a pseudo-peripheral cell:
+      the lowest degree cell of the last level of a first search*/
+    IntVector visited(gBCS,0),level(gBCS,0);
+    Int next = 0;
+    order.clear();
+    while(order.size() < gBCS) {
+        while(visited[byDegree[next].second]) next++;
+        Int start = byDegree[next].second;
+        IntVector comp;
+        cuthillMcKee(start,xadj,adj,visited,2,level,comp);
+        Int last = level[comp.back()];
+        forEach(comp,j) {
+            Int n = comp[j];
+            if(level[n] == last && (level[start] != last || 
+               xadj[n + 1] - xadj[n] < xadj[start + 1] - xadj[start]))
+                start = n;
+            visited[n] = 0;
+        }
+        cuthillMcKee(start,xadj,adj,visited,1,level,order);
+    }
+    std::reverse(order.begin(),order.end());
+}
+/**
+Space filling curve (Morton order) of cell centers
+*/
+void orderSFC(IntVector& order) {
+    using namespace Mesh;
+    typedef unsigned long long Key;
+    const Int BITS = 21;
+    
+    /*bounding box*/
+    Vector maxV(Scalar(-10e30)),minV(Scalar(10e30));
+    for(Int i = 0;i < gBCS;i++) {
+        for(Int j = 0;j < 3;j++) {
+            if(gCC[i][j] > maxV[j]) maxV[j] = gCC[i][j];
+            if(gCC[i][j] < minV[j]) minV[j] = gCC[i][j];
+        }
+    }
+    
+    /*interleave bits of quantized coordinates*/
+    std::vector< std::pair<Key,Int> > keys(gBCS);
+    for(Int i = 0;i < gBCS;i++) {
+        Int q[3];
+        for(Int j = 0;j < 3;j++) {
+            Scalar d = maxV[j] - minV[j];
+            q[j] = (d > 0) ? Int((gCC[i][j] - minV[j]) / d * ((1 << BITS) - 1)) : 0;
+        }
+        Key k = 0;
+        for(Int b = BITS;b-- > 0;) {
+            for(Int j = 0;j < 3;j++)
+                k = (k << 1) | ((q[j] >> b) & 1);
+        }
+        keys[i] = std::make_pair(k,i);
+    }
+    std::sort(keys.begin(),keys.end());
+    order.resize(gBCS);
+    for(Int i = 0;i < gBCS;i++)
+        order[i] = keys[i].second;
+}
+/**
+Cells not next to a boundary, which addBoundaryCells places first on load
+*/
+static bool isInterior(Int c) {
+    return c < Mesh::gBCSI;
+}
+/**
+Largest distance between owner and neighbor of internal faces
+*/
+static Int bandwidth() {
+    using namespace Mesh;
+    Int bw = 0;
+    forEach(gFacets,f) {
+        if(gFNC[f] < gBCS && gFNC[f] - gFOC[f] > bw)
+            bw = gFNC[f] - gFOC[f];
+    }
+    return bw;
+}
+
+}
+/**
+Renumber cells and faces to reduce matrix bandwidth
+*/
+void Prepare::renumberMesh(Int step) {
+    using namespace Mesh;
+    using namespace Controls;
+
+    /*Load mesh*/
+    LoadMesh(step,true,false);
+    if(gInterMesh.size()) {
+        std::cout << "Renumber the mesh before decomposing it." << std::endl;
+        return;
+    }
+
+    /*create fields*/
+    Prepare::createFields(BaseField::fieldNames,step);
+    Prepare::readFields(BaseField::fieldNames,step);
+
+    /*new order of internal cells*/
+    IntVector order;
+    if(renumber_params.type == 1)
+        orderSFC(order);
+    else
+        orderRCM(order);
+    /*keep the partition into interior and boundary cells so that
+      the mesh loads back in the order the fields are written in*/
+    std::stable_partition(order.begin(),order.end(),isInterior);
+    
+    /*renumber mesh*/
+    Int bw = bandwidth();
+    gCells.erase(gCells.begin() + gBCS,gCells.end());
+    gMesh.renumber(order);
+    std::cout << "Matrix bandwidth " << bw << " -> " << bandwidth() << std::endl;
+    
+    /*write fields in the new order*/
+    {
+        IntVector cellMap(order.size() * DG::NP),coarseMap;
+        forEach(order,i) {
+            for(Int n = 0;n < DG::NP;n++)
+                cellMap[i * DG::NP + n] = order[i] * DG::NP + n;
+        }
+        forEachIt(std::list<BaseField*>, BaseField::allFields, it)
+            (*it)->refineField(step,cellMap,coarseMap);
+    }
+    /*renumber amr tree*/
+    {
+        stringstream path;
+        int stepn = findLastRefinedGrid(step);
+        path << "amrTree" << "_" << stepn;
+        ifstream is(path.str().c_str());
+        if(!is.fail()) {
+            is >> hex;
+            is >> gAmrTree;
+            is >> dec;
+            IntVector cellMap(order.size());
+            forEach(order,i)
+                cellMap[order[i]] = i;
+            forEach(gAmrTree,i) {
+                Node& n = gAmrTree[i];
+                if(n.id < cellMap.size())
+                    n.id = cellMap[n.id];
+            }
+            stringstream opath;
+            opath << "amrTree" << "_" << step;
+            ofstream os(opath.str().c_str());
+            os << hex;
+            os << gAmrTree;
+            os << dec;
+        }
+    }
+    /*Write mesh*/
+    {
+        stringstream path;
+        path << gMeshName << "_" << step;
+        ofstream os(path.str().c_str());
+        gMesh.writeMesh(os);
+    }
+
+    /*destroy*/
+    BaseField::destroyFields();
+}
+
 /*********************************
  *
  * Domain Decomposition
@@ -715,11 +1161,12 @@ Decompose using METIS 5.0
 void decomposeMetis(int total,IntVector& blockIndex) {
     using namespace Mesh;
     
-    int ncon = 1;
-    int edgeCut = 0;
-    int ncells = gBCS;
-    std::vector<int> xadj,adjncy;
-    std::vector<int> options(METIS_NOPTIONS);
+    idx_t ncon = 1;
+    idx_t edgeCut = 0;
+    idx_t ncells = gBCS;
+    idx_t nparts = total;
+    std::vector<idx_t> xadj,adjncy,part(gBCS);
+    std::vector<idx_t> options(METIS_NOPTIONS);
     
     /*default options*/
     METIS_SetDefaultOptions(&options[0]);
@@ -750,13 +1197,189 @@ void decomposeMetis(int total,IntVector& blockIndex) {
         NULL,
         NULL,
         NULL,
-        &total,
+        &nparts,
         NULL,
         NULL,
         &options[0],
         &edgeCut,
-        (int*)(&blockIndex[0])
+        &part[0]
     );
+    forEach(part,i)
+        blockIndex[i] = part[i];
+}
+
+/**
+Halo faces between partitions placed on the same node and on different nodes
+*/
+void countHaloFaces(Int total,const IntVector& w,const IntVector& node,
+                           const IntVector& rank,Int& intra,Int& inter) {
+    intra = inter = 0;
+    for(Int a = 0;a < total;a++) {
+        for(Int b = a + 1;b < total;b++) {
+            if(node[rank[a]] == node[rank[b]])
+                intra += w[a * total + b];
+            else
+                inter += w[a * total + b];
+        }
+    }
+}
+/**
+Map partitions to processors so that partitions sharing large interfaces
+are placed on the same node (or group of group_size processors).
+Groups are grown greedily from the partition least connected to the rest.
+*/
+void mapToNodes(Int total,Int group_size,IntVector& blockIndex) {
+    using namespace Mesh;
+    using namespace Constants;
+    
+    Int i,j,k;
+    for(i = 0;i < gBCS;i++) {
+        if(blockIndex[i] >= total)
+            return;
+    }
+    
+    /*node of processors*/
+    IntVector node(total);
+    Int n_nodes = 0;
+    for(i = 0;i < total;i++) {
+        node[i] = group_size ? (i / group_size) : MP::host_node[i];
+        if(node[i] + 1 > n_nodes) n_nodes = node[i] + 1;
+    }
+    
+    /*communication graph of partitions*/
+    IntVector w(total * total,0);
+    forEach(gFacets,f) {
+        if(gFNC[f] >= gBCS) continue;
+        Int a = blockIndex[gFOC[f]];
+        Int b = blockIndex[gFNC[f]];
+        if(a != b) {
+            w[a * total + b]++;
+            w[b * total + a]++;
+        }
+    }
+    
+    /*grow groups of partitions*/
+    IntVector rank(total,MAX_INT),identity(total);
+    for(i = 0;i < total;i++)
+        identity[i] = i;
+    for(Int nd = 0;nd < n_nodes;nd++) {
+        IntVector group;
+        for(i = 0;i < total;i++) {
+            if(node[i] != nd) continue;
+            /*connection to current group or, for the seed, to the rest*/
+            Int best = MAX_INT;
+            int bestw = 0;
+            for(j = 0;j < total;j++) {
+                if(rank[j] != MAX_INT) continue;
+                int wj = 0;
+                if(group.size()) {
+                    forEach(group,m)
+                        wj += w[j * total + group[m]];
+                } else {
+                    for(k = 0;k < total;k++) {
+                        if(rank[k] == MAX_INT && k != j)
+                            wj -= w[j * total + k];
+                    }
+                }
+                if(best == MAX_INT || wj > bestw) {
+                    best = j;
+                    bestw = wj;
+                }
+            }
+            rank[best] = i;
+            group.push_back(best);
+        }
+    }
+    
+    /*report and keep the better of the two mappings*/
+    Int intra0,inter0,intra,inter;
+    countHaloFaces(total,w,node,identity,intra0,inter0);
+    countHaloFaces(total,w,node,rank,intra,inter);
+    if(n_nodes == 1 || inter >= inter0) {
+        rank = identity;
+        intra = intra0;
+        inter = inter0;
+    }
+    std::cout << "Halo faces on " << n_nodes << " node(s): intra-node " 
+              << intra << " inter-node " << inter 
+              << " (direct mapping inter-node " << inter0 << ")" << std::endl;
+    for(i = 0;i < gBCS;i++)
+        blockIndex[i] = rank[blockIndex[i]];
+}
+/**
+Copy initial fields to the parts of a mesh generated already decomposed,
+adding a GHOST condition for each inter mesh boundary of a part as done
+by decomposeMesh. Fields given cell by cell can not be copied without
+the whole mesh.
+*/
+int distributeFields(Int step) {
+    using namespace Mesh;
+    
+    /*parts share the working directory, so one processor copies to all*/
+    if(MP::host_id != 0)
+        return 0;
+    
+    Int total = MP::n_hosts;
+    vector<string>& fields = BaseField::fieldNames;
+    std::cout << "Copying fields to parts of grid at step " << step << std::endl;
+    
+    /*inter mesh boundaries of each part*/
+    vector< vector<string> > interMesh(total);
+    for(Int ID = 0;ID < total;ID++) {
+        stringstream path;
+        path << gMeshName << ID << "/" << gMeshName << "_0";
+        ifstream is(path.str().c_str());
+        string line;
+        while(std::getline(is,line)) {
+            if(line.compare(0,10,"interMesh_") == 0) {
+                stringstream ss(line);
+                string name;
+                ss >> name;
+                interMesh[ID].push_back(name);
+            }
+        }
+    }
+    
+    forEach(fields,i) {
+        stringstream fpath;
+        fpath << fields[i] << step;
+        ifstream is(fpath.str().c_str());
+        if(is.fail())
+            continue;
+        
+        /*internal field*/
+        string str;
+        int size;
+        char c;
+        is >> str >> size;
+        if(!((c = Util::nextc(is)) && isalpha(c))) {
+            std::cout << "Field " << fpath.str() 
+                      << " is given cell by cell and is not copied" << std::endl;
+            continue;
+        }
+        is.seekg(0);
+        stringstream contents;
+        contents << is.rdbuf();
+        string text = contents.str();
+        if(text.size() && text[text.size() - 1] != '\n')
+            text += '\n';
+        
+        /*copy*/
+        for(Int ID = 0;ID < total;ID++) {
+            stringstream path;
+            path << gMeshName << ID << "/" << fpath.str();
+            ofstream of(path.str().c_str());
+            of << text;
+            
+            /*inter mesh boundaries*/
+            vector<string>& names = interMesh[ID];
+            forEach(names,j) {
+                of << names[j] << " "
+                   << "{\n\ttype GHOST\n}" << endl;
+            }
+        }
+    }
+    return 0;
 }
 
 }
@@ -776,9 +1399,21 @@ int Prepare::decomposeMesh(Int step) {
     if(total == 1)
         return 1;
     
-    std::cout << "Decomposing grid at step " << step << std::endl;
     System::cd(MP::workingDir);
     
+    /*mesh generated in parts*/
+    {
+        stringstream path,path1;
+        path << gMeshName << "_" << findLastRefinedGrid(step);
+        path1 << gMeshName << 0 << "/" << gMeshName << "_0";
+        ifstream is(path.str().c_str()),is0(gMeshName.c_str());
+        ifstream is1(path1.str().c_str());
+        if(is.fail() && is0.fail() && !is1.fail())
+            return distributeFields(step);
+    }
+    
+    std::cout << "Decomposing grid at step " << step << std::endl;
+    
     /*Read mesh*/
     LoadMesh(step,true,false);
 
@@ -789,10 +1424,10 @@ int Prepare::decomposeMesh(Int step) {
     /**********************
      * decompose mesh
      **********************/
-    MeshObject* meshes = new MeshObject[total];
-    IntVector* vLoc = new IntVector[total];
-    IntVector* fLoc = new IntVector[total];
-    IntVector* cLoc = new IntVector[total];
+    std::vector<MeshObject> meshes(total);
+    std::vector<IntVector> vLoc(total);
+    std::vector<IntVector> fLoc(total);
+    std::vector<IntVector> cLoc(total);
     for(i = 0;i < total;i++) {
         vLoc[i].assign(gVertices.size(),0);
         fLoc[i].assign(gFacets.size(),0);
@@ -819,9 +1454,28 @@ int Prepare::decomposeMesh(Int step) {
         decomposeMetis(total,blockIndex);
     else; //default -- assigns all to processor 0
     
-    /*add cells*/
+    /*place partitions on nodes*/
+    mapToNodes(total,dp.group_size,blockIndex);
+    
+    /*add cells: those next to a boundary or another block go last
+      so that addBoundaryCells keeps the order of the index file*/
+    BoolVector nextToBoundary(gBCS,false);
+    for(i = 0;i < gBCS;i++) {
+        Cell& c = gCells[i];
+        forEach(c,j) {
+            Int f = c[j];
+            Int n = (gFOC[f] == i) ? gFNC[f] : gFOC[f];
+            if(n >= gBCS || blockIndex[n] != blockIndex[i]) {
+                nextToBoundary[i] = true;
+                break;
+            }
+        }
+    }
+    for(Int pass = 0;pass < 2;pass++) {
     for(i = 0;i < gBCS;i++) {
         Cell& c = gCells[i];
+        if(nextToBoundary[i] != (pass == 1))
+            continue;
 
         /* add cell */
         ID = blockIndex[i];
@@ -840,6 +1494,57 @@ int Prepare::decomposeMesh(Int step) {
             }
         }
     }
+    }
+    
+    /*add neighbors of cells owned by other blocks (ghost depth 2)*/
+    Int depth = dp.ghost_depth;
+    if(depth > 1 && DG::NPMAT) {
+        std::cout << "Ghost depth 2 is not supported for DG, using 1" << std::endl;
+        depth = 1;
+    }
+    std::vector<IntVector> hLoc(total);
+    std::vector<IntVector> lLoc(total);
+    if(depth > 1) {
+        for(i = 0;i < gBCS;i++) {
+            Cell& c = gCells[i];
+            ID = blockIndex[i];
+            forEach(c,j) {
+                Int f = c[j];
+                Int n = (gFOC[f] == i) ? gFNC[f] : gFOC[f];
+                if(n < gBCS && blockIndex[n] != ID)
+                    hLoc[ID].push_back(n);
+            }
+        }
+        for(ID = 0;ID < total;ID++) {
+            pmesh = &meshes[ID];
+            pvLoc = &vLoc[ID];
+            pfLoc = &fLoc[ID];
+            
+            IntVector& h = hLoc[ID];
+            std::sort(h.begin(),h.end());
+            h.erase(std::unique(h.begin(),h.end()),h.end());
+            
+            /*local index of cells*/
+            IntVector& l = lLoc[ID];
+            l.assign(gBCS,MAX_INT);
+            forEach(cLoc[ID],j)
+                l[cLoc[ID][j]] = j;
+            forEach(h,j)
+                l[h[j]] = cLoc[ID].size() + j;
+            
+            /*add halo cells after internal cells*/
+            forEach(h,j) {
+                Cell& c = gCells[h[j]];
+                pmesh->mCells.push_back(c);
+                forEach(c,k) {
+                    Facet& f = gFacets[c[k]];
+                    (*pfLoc)[c[k]] = 1;
+                    forEach(f,m)
+                        (*pvLoc)[f[m]] = 1; 
+                }
+            }
+        }
+    }
     
     /*add vertices & facets*/
     for(ID = 0;ID < total;ID++) {
@@ -884,15 +1589,57 @@ int Prepare::decomposeMesh(Int step) {
         }
     }
     /*inter mesh faces*/
-    IntVector* imesh = new IntVector[total * total];
+    std::vector<IntVector> imesh(total * total);
+    std::vector<IntVector> ihalo(total * total);
+    std::vector<IntVector> isend(total * total);
     Int co,cn;
-    forEach(gFacets,i) {
-        if(gFNC[i] < gBCS) {
-            co = blockIndex[gFOC[i]];
-            cn = blockIndex[gFNC[i]];
-            if(co != cn) {
-                imesh[co * total + cn].push_back(fLoc[co][i]);
-                imesh[cn * total + co].push_back(fLoc[cn][i]);
+    if(depth > 1) {
+        /*faces of halo cells to cells of other blocks*/
+        std::vector<IntVector> hcell(total * total);
+        std::vector<IntVector> icell(total * total);
+        for(ID = 0;ID < total;ID++) {
+            IntVector& h = hLoc[ID];
+            IntVector& l = lLoc[ID];
+            forEach(h,j) {
+                Int ci = h[j];
+                co = blockIndex[ci];
+                ihalo[ID * total + co].push_back(l[ci]);
+                hcell[ID * total + co].push_back(ci);
+                
+                Cell& c = gCells[ci];
+                forEach(c,k) {
+                    Int f = c[k];
+                    Int n = (gFOC[f] == ci) ? gFNC[f] : gFOC[f];
+                    if(n < gBCS && l[n] == MAX_INT) {
+                        cn = blockIndex[n];
+                        imesh[ID * total + cn].push_back(fLoc[ID][f]);
+                        icell[ID * total + cn].push_back(n);
+                    }
+                }
+            }
+        }
+        /*cells to send in the order the neighbor recieves them*/
+        for(ID = 0;ID < total;ID++) {
+            IntVector& l = lLoc[ID];
+            for(j = 0;j < total;j++) {
+                IntVector& sc = isend[ID * total + j];
+                IntVector& hc = hcell[j * total + ID];
+                IntVector& fc = icell[j * total + ID];
+                forEach(hc,k)
+                    sc.push_back(l[hc[k]]);
+                forEach(fc,k)
+                    sc.push_back(l[fc[k]]);
+            }
+        }
+    } else {
+        forEach(gFacets,i) {
+            if(gFNC[i] < gBCS) {
+                co = blockIndex[gFOC[i]];
+                cn = blockIndex[gFNC[i]];
+                if(co != cn) {
+                    imesh[co * total + cn].push_back(fLoc[co][i]);
+                    imesh[cn * total + co].push_back(fLoc[cn][i]);
+                }
             }
         }
     }
@@ -903,11 +1650,10 @@ int Prepare::decomposeMesh(Int step) {
         const Int block = DG::NP;
         IntVector& cF = cLoc[ID];
         cF.resize(cF.size() * block);
-        for(int i = cF.size() - 1;i >= 0;i -= block) {
-            Int ii = i / block;
-            Int C = cF[ii] * block;
+        for(Int i = cF.size() / block;i > 0;i--) {
+            Int C = cF[i - 1] * block;
             for(Int j = 0; j < block;j++)
-                cF[i - j] = C + block - 1 - j; 
+                cF[(i - 1) * block + j] = C + j; 
         }
     }
     /***************************
@@ -955,10 +1701,18 @@ int Prepare::decomposeMesh(Int step) {
         /*inter mesh boundaries*/
         for(j = 0;j < total;j++) {
             IntVector& f = imesh[ID * total + j];
-            if(f.size()) {
+            IntVector& hc = ihalo[ID * total + j];
+            IntVector& sc = isend[ID * total + j];
+            if(f.size() || hc.size() || sc.size()) {
                 of << "interMesh_" << ID << "_" << j << " ";
                 of << f << endl;
             }
+            if(hc.size() || sc.size()) {
+                of << "interHalo_" << ID << "_" << j << " ";
+                of << hc << endl;
+                of << "interSend_" << ID << "_" << j << " ";
+                of << sc << endl;
+            }
         }
         
         of << dec;
@@ -997,13 +1751,6 @@ int Prepare::decomposeMesh(Int step) {
     /*destroy*/ 
     BaseField::destroyFields();
     
-    /*delete*/
-    delete[] meshes;
-    delete[] imesh;
-    delete[] vLoc;
-    delete[] fLoc;
-    delete[] cLoc;
-    
     return 0;
 }
 /**
@@ -1017,7 +1764,7 @@ int Prepare::mergeFields(Int step) {
     
     /*indexes*/
     Int total = MP::n_hosts;
-    IntVector* cLoc = new IntVector[total];
+    std::vector<IntVector> cLoc(total);
 
     std::cout << "Merging fields at step " << step << std::endl;
 
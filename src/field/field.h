@@ -3,6 +3,10 @@
 
 #include "mesh.h"
 #include "mp.h"
+#include "threads.h"
+#include "simd.h"
+#include "arena.h"
+#include <utility>
 
 /** Basic building blocks (entities) over which fields are defined */
 enum ENTITY {
@@ -33,14 +37,26 @@ struct DecomposeParams {
     Int type;
     IntVector n;
     ScalarVector axis;
+    Int ghost_depth;
+    Int group_size;
     DecomposeParams() {
         type = 2;
+        ghost_depth = 1;
+        group_size = 0;
         axis.assign(4,0);
         axis[0] = 1;
         n.assign(3,1);
     }
 };
 
+/** Renumbering parameters */
+struct RenumberParams {
+    Int type;
+    RenumberParams() {
+        type = 0;
+    }
+};
+
 namespace Mesh {
     void enroll(Util::ParamList& params);
 }
@@ -48,8 +64,10 @@ namespace Mesh {
 namespace Controls {
     extern RefineParams refine_params;
     extern DecomposeParams decompose_params;
+    extern RenumberParams renumber_params;
     void enrollRefine(Util::ParamList& params);
     void enrollDecompose(Util::ParamList& params);
+    void enrollRenumber(Util::ParamList& params);
 }
 
 /*******************************************************************************
@@ -362,6 +380,10 @@ namespace Controls {
     extern Int n_deferred;
     extern Int save_average;
     extern Int print_time;
+    extern Int reduced_halo;
+    extern Int n_threads;
+    extern Int huge_pages;
+    extern Int packed_faces;
 
     extern Vector gravity;
 }
@@ -384,6 +406,12 @@ namespace Mesh {
     extern IntVector  probeCells;
     extern Int  gBCSfield; 
     extern Int  gBCSIfield;
+    extern Int  gHCSfield;
+    /** Faces of each cell and vertices of each face. Meshes loaded for 
+    solving keep only this compressed form and release the rows of 
+    gCells and gFacets */
+    extern Compressed  gCellFaces;
+    extern Compressed  gFaceVertices;
 };
 
 /* *****************************************************************************
@@ -441,7 +469,6 @@ public:
     /*common*/
     static const Int TYPE_SIZE = sizeof(type) / sizeof(Scalar);
     static std::list<MeshField*> fields_;
-    static std::list<type*> mem_pool;
     static Int n_alloc, n_alloc_max;
 
     /*constructors*/
@@ -451,44 +478,82 @@ public:
         fName = str;
         construct(str,a,recycle);
     }
-    MeshField(const MeshField& p) : allocated(0) {
+    MeshField(const MeshField& p) : allocated(0),access(NO),fIndex(0) {
         allocate(); 
-        forEach(*this,i)
-            P[i] = p[i];
+        *this = p;
     }
-    MeshField(const type& p) : allocated(0) {
+    MeshField(const type& p) : allocated(0),access(NO),fIndex(0) {
         allocate(); 
-        forEach(*this,i)
+        forEachP(*this,i)
             P[i] = p;
     }
-    explicit MeshField(const bool) : allocated(0) {
+    explicit MeshField(const bool) : allocated(0),access(NO),fIndex(0) {
+        P = 0;
+    }
+#if __cplusplus >= 201103L
+    /*temporaries hand over their storage, registered fields are copied*/
+    MeshField(MeshField&& p) : allocated(0),access(NO),fIndex(0) {
+        if(p.allocated && !p.fIndex) {
+            P = p.P;
+            allocated = 1;
+            p.P = 0;
+            p.allocated = 0;
+        } else {
+            allocate();
+            *this = p;
+        }
     }
+    MeshField& operator =(MeshField&& q) {
+        if(!q.allocated || fIndex || q.fIndex) 
+            return *this = q;
+        if(allocated) {
+            std::swap(P,q.P);
+        } else {
+            P = q.P;
+            allocated = 1;
+            q.P = 0;
+            q.allocated = 0;
+        }
+        return *this;
+    }
+#endif
     /*allocators*/
     void allocate(bool recycle = true) {
-        if(!recycle || mem_pool.empty()) {
-            switch(entity) {
-                case CELL:   SIZE = Mesh::gCells.size() * DG::NP;    break;
-                case FACET:  SIZE = Mesh::gFacets.size() * DG::NPF;  break;
-                case VERTEX: SIZE = Mesh::gVertices.size();          break;
-                case CELLMAT:SIZE = Mesh::gCells.size() * DG::NPMAT; break;
-            }
-            Int sz = SIZE;
-            if(entity == CELL) 
-                sz += 1;
-            else if(entity == CELLMAT) 
-                sz += DG::NP;
-            P = new type[sz];
-            
-            n_alloc++;
-            if(n_alloc > n_alloc_max)
-                n_alloc_max = n_alloc;
-        } else {
-            P = mem_pool.front();
-            mem_pool.pop_front();
+        switch(entity) {
+            case CELL:   SIZE = Mesh::gCellFaces.size() * DG::NP;    break;
+            case FACET:  SIZE = Mesh::gFaceVertices.size() * DG::NPF;  break;
+            case VERTEX: SIZE = Mesh::gVertices.size();          break;
+            case CELLMAT:SIZE = Mesh::gCellFaces.size() * DG::NPMAT; break;
+        }
+        Int sz = SIZE;
+        if(entity == CELL) 
+            sz += 1;
+        else if(entity == CELLMAT) 
+            sz += DG::NP;
+        bool fresh;
+        P = (type*) Arena::alloc(sz * sizeof(type),&fresh);
+        
+        /*first touch by the thread that works on it*/
+        if(fresh) {
+            forRangeP(sz,i,sizeof(type))
+                P[i] = type(0);
         }
+        
+        n_alloc++;
+        if(n_alloc > n_alloc_max)
+            n_alloc_max = n_alloc;
 
         allocated = 1;
     }
+    /** Use the storage of another field */
+    void share(const MeshField& q) {
+        if(allocated) 
+            deallocate();
+        P = &q[0];
+    }
+    bool shares(const MeshField& q) const {
+        return P == &q[0];
+    }
     void allocate(std::vector<type>& q) {
         SIZE = q.size();
         P = &q[0];
@@ -497,13 +562,10 @@ public:
     void deallocate(bool recycle = true) {
         if(allocated) {
             allocated = 0;
-            if(recycle) {
-                mem_pool.push_front(P);
-            } else {
-                delete[] P;
+            Arena::free(P,recycle);
+            if(!recycle)
                 P = 0;
-                n_alloc--;
-            }
+            n_alloc--;
             if(fIndex) {
                 fields_.remove(this);
                 allFields.remove(this);
@@ -514,7 +576,7 @@ public:
     void construct(const char* str = "", ACCESS a = NO, bool recycle = true) {
         access = a;
         fName = str;
-        if(Mesh::gCells.size())
+        if(Mesh::gCellFaces.size())
             allocate(recycle);
         fIndex = Util::hash_function(str);
         if(fIndex) {
@@ -535,40 +597,40 @@ public:
         return P[i];
     }
     
-    /*Assignment from Meshfield and Scalar*/
-#define Op($)                                                       \
+    /*Assignment from Meshfield and Scalar on flat array of scalars*/
+#define Op($,name,val)                                              \
     MeshField& operator $(const MeshField& q) {                     \
-        forEach(*this,i)                                            \
-            P[i] $ q[i];                                            \
+        forChunkP(SIZE,sizeof(type),s,e)                            \
+            Simd::name((Scalar*)(P + s),val,(e - s) * TYPE_SIZE);   \
         return *this;                                               \
     }
-#define SOp($)                                                      \
+#define SOp($,name,val)                                             \
     MeshField& operator $(const Scalar& q) {                        \
-        forEach(*this,i)                                            \
-            P[i] $ q;                                               \
+        forChunkP(SIZE,sizeof(type),s,e)                            \
+            Simd::name((Scalar*)(P + s),val,(e - s) * TYPE_SIZE);   \
         return *this;                                               \
     }
-    Op(=)
-    SOp(=)
-    SOp(+=)
-    SOp(-=)
-    SOp(*=)
-    SOp(/=)
+    Op(=,copy,(const Scalar*)(&q[s]))
+    SOp(=,fill,q)
+    SOp(+=,add,q)
+    SOp(-=,add,-q)
+    SOp(*=,mul,q)
+    SOp(/=,mul,1 / q)
 #undef Op
 #undef SOp
         
     /*Assignment from expressions*/
     template <class A>
-    MeshField(const DVExpr<type,A>& p) {
+    MeshField(const DVExpr<type,A>& p) : allocated(0),access(NO),fIndex(0) {
         allocate();
-        forEach(*this,i)
+        forEachP(*this,i)
             P[i] = p[i];
     }
 
 #define Op($)                                                       \
     template <class A>                                              \
     MeshField& operator $(const DVExpr<type,A>& q) {                \
-        forEach(*this,i)                                            \
+        forEachP(*this,i)                                           \
             P[i] $ q[i];                                            \
         return *this;                                               \
     }
@@ -606,10 +668,6 @@ public:
     } 
     static void removeAll() {
         fields_.clear();
-        forEachIt(typename std::list<type*>,mem_pool,it)
-            delete[] (*it);
-        mem_pool.clear();
-        n_alloc = 0;
     } 
     static int count_writable() {
         int count = 0;
@@ -664,15 +722,15 @@ public:
     Int nstore;
     Int nstored;
     void initStore() {
-        nstore = Controls::time_scheme - Controls::BDF1 + 1;
+        nstore = unsigned(Controls::time_scheme - Controls::BDF1) + 1;
         tstore = new MeshField[nstore];
         access = ACCESS(int(access) | STOREPREV);
-        for(int i = 0;i < nstore;i++)
+        for(Int i = 0;i < nstore;i++)
             tstore[i] = *this;
         nstored = 0;
     }
     void updateStore() {
-        for(int i = 0;i < nstore - 1;i++)
+        for(Int i = 0;i < nstore - 1;i++)
             tstore[nstore - i - 1] = tstore[nstore - i - 2];
         tstore[0] = *this;
         nstored++;
@@ -807,9 +865,6 @@ typedef MeshField<STensor,VERTEX> STensorVertexField;
 template <class T,ENTITY E> 
 std::list<MeshField<T,E>*> MeshField<T,E>::fields_;
 
-template <class T,ENTITY E> 
-std::list<T*> MeshField<T,E>::mem_pool;
-
 template <class T,ENTITY E> 
 Int MeshField<T,E>::n_alloc;
 
@@ -846,9 +901,39 @@ namespace Mesh {
     extern ScalarCellField   yWall;
     extern IntVector         FO;
     extern IntVector         FN; 
+    extern IntVector         gFaceGroups;
+    extern IntVector         gGroupStart;
+    extern IntVector         gColorStart;
+    extern IntVector         gGroupColor;
+    extern bool              gFaceColored;
+    extern bool              gEarlySend;
+    extern IntVector         gFaceRuns;
+    extern IntVector         gGroupRuns;
+    extern IntVector         gGroupRun;
+    
+    /** Indices and geometry of a face packed in one record */
+    struct FaceStencil {
+        Int    o;       /**< Owner cell */
+        Int    n;       /**< Neighbor cell */
+        Scalar fI;      /**< Interpolation factor to the owner */
+        Scalar fD;      /**< Diffusivity factor */
+        Vector fN;      /**< Area normal */
+    };
+    extern std::vector<FaceStencil> gStencil;
+    
+    /** Face groups, physical boundary patches follow in the order of gBoundaries */
+    enum FaceGroup {
+        INNER_FACES,        /**< Interior faces away from halo and boundary cells */
+        INTERIOR_FACES,     /**< Remaining interior faces */
+        PROCESSOR_FACES,    /**< Faces that need halo values */
+        BOUNDARY_FACES      /**< Faces of the first physical boundary patch */
+    };
     
     bool   LoadMesh(Int = 0,bool = true, bool = true);
     void   initGeomMeshFields();
+    void   groupFaces();
+    void   packFaces();
+    void   findFaceRuns();
     void   calc_walldist(Int,Int = 1);
     void   write_fields(Int);
     void   read_fields(Int);
@@ -860,8 +945,91 @@ namespace Mesh {
     void   calc_courant(const VectorCellField& U, Scalar dt);
     template <class type>
     void   scaleBCs(const MeshField<type,CELL>&, MeshField<type,CELL>&, Scalar);
+
+    /** Number of face colors, one if face loops run serially */
+    inline Int nFaceColors() {
+        return gFaceColored ? gColorStart.size() - 1 : 1;
+    }
+    /** Start of faces of a color */
+    inline Int faceColorStart(Int c) {
+        return gFaceColored ? gColorStart[c] : (c ? FN.size() : 0);
+    }
+    /** j-th face in color order */
+    inline Int faceColorFace(Int j) {
+        return gFaceColored ? gFaceGroups[j] : j;
+    }
+    /** Number of faces of a color processed in parallel */
+    inline Int faceColorSize(Int c) {
+        return gFaceColored ? gColorStart[c + 1] - gColorStart[c] : 0;
+    }
+    /** Stencil of a face from the packed records or the separate arrays */
+    inline FaceStencil faceStencil(Int f) {
+        if(!gStencil.empty())
+            return gStencil[f];
+        FaceStencil s;
+        s.o = FO[f];
+        s.n = FN[f];
+        s.fI = fI[f];
+        s.fD = fD[f];
+        s.fN = fN[f];
+        return s;
+    }
+    /** Number of face groups */
+    inline Int nFaceGroups() {
+        return gGroupStart.size() - 1;
+    }
+    /** Are face loops done over runs of structured faces */
+    inline bool structuredFaces() {
+        return !gFaceRuns.empty();
+    }
 }
 
+/** Loop over faces scattering to cells. Faces of the same color do not
+    share cells and are processed in parallel. Without colors the loop
+    runs serially. */
+#define forEachFaceP(f)                                                 \
+    for(Int c_ = 0;c_ < Mesh::nFaceColors();c_++)                       \
+    PARALLEL(Mesh::faceColorSize(c_))                                   \
+    for(Int j_e, j_ = Threads::chunk(Mesh::faceColorStart(c_),          \
+            Mesh::faceColorStart(c_ + 1),sizeof(Int),j_e);j_ < j_e;j_++)\
+    for(Int f = Mesh::faceColorFace(j_), o_ = 1;o_;o_ = 0)
+
+/** Loop over faces of groups [g0,g1) */
+#define forEachFaceInP(g0,g1,f)                                         \
+    for(Int c_ = Mesh::gGroupColor[g0];c_ < Mesh::gGroupColor[g1];c_++) \
+    PARALLEL(Mesh::faceColorSize(c_))                                   \
+    for(Int j_e, j_ = Threads::chunk(Mesh::gColorStart[c_],             \
+            Mesh::gColorStart[c_ + 1],sizeof(Int),j_e);j_ < j_e;j_++)   \
+    for(Int f = Mesh::gFaceGroups[j_], o_ = 1;o_;o_ = 0)
+
+/** Split-phase loops: faces that do not need halo values are processed
+    while the exchange is in flight, the rest after it completes */
+#define forEachInteriorFaceP(f)                                         \
+    forEachFaceInP(Mesh::INNER_FACES,Mesh::PROCESSOR_FACES,f)
+#define forEachHaloFaceP(f)                                             \
+    forEachFaceInP(Mesh::PROCESSOR_FACES,Mesh::nFaceGroups(),f)
+
+/** Loops over runs of faces along which face, owner and neighbor
+    indices all increase by one, as in structured blocks. Cells c1 and
+    c2 of a face are then addressed directly. */
+#define forEachFaceRun(f,c1,c2)                                         \
+    for(Int r_ = 0;r_ + 1 < Mesh::gFaceRuns.size();r_++)                \
+    for(Int f0_ = Mesh::gFaceRuns[r_], f1_ = Mesh::gFaceRuns[r_ + 1],   \
+            o_ = Mesh::FO[f0_] - f0_, n_ = Mesh::FN[f0_] - f0_,         \
+            f = f0_;f < f1_;f++)                                        \
+    for(Int c1 = f + o_, c2 = f + n_, k_ = 1;k_;k_ = 0)
+
+#define forEachFaceRunIn(g0,g1,f,c1,c2)                                 \
+    for(Int r_ = Mesh::gGroupRun[g0];r_ < Mesh::gGroupRun[g1];r_++)     \
+    for(Int f0_ = Mesh::gFaceGroups[Mesh::gGroupRuns[r_]],              \
+            f1_ = f0_ + Mesh::gGroupRuns[r_ + 1] - Mesh::gGroupRuns[r_],\
+            o_ = Mesh::FO[f0_] - f0_, n_ = Mesh::FN[f0_] - f0_,         \
+            f = f0_;f < f1_;f++)                                        \
+    for(Int c1 = f + o_, c2 = f + n_, k_ = 1;k_;k_ = 0)
+
+#define forEachInteriorFaceRun(f,c1,c2)                                 \
+    forEachFaceRunIn(Mesh::INNER_FACES,Mesh::PROCESSOR_FACES,f,c1,c2)
+
 namespace Prepare {
     void createFields(std::vector<std::string>& fields,Int step);
     Int  readFields(std::vector<std::string>& fields,Int step);
@@ -870,16 +1038,34 @@ namespace Prepare {
     void initRefineThreshold();
     int decomposeMesh(Int);
     int mergeFields(Int);
+    void renumberMesh(Int);
 }
 
+/** central difference value at a face */
+template<class type>
+inline type cds(const MeshField<type,CELL>& cF,const Int f) {
+    using namespace Mesh;
+    return (cF[FO[f]] * (fI[f])) + (cF[FN[f]] * (1 - fI[f]));
+}
+/** central difference value at a face with known owner and neighbor */
+template<class type>
+inline type cds(const MeshField<type,CELL>& cF,const Int f,const Int c1,const Int c2) {
+    using namespace Mesh;
+    return (cF[c1] * (fI[f])) + (cF[c2] * (1 - fI[f]));
+}
+/** central difference scheme into an existing field */
+template<class type>
+void cds(MeshField<type,FACET>& fF,const MeshField<type,CELL>& cF) {
+    using namespace Mesh;
+    forChunkP(fF.size(),sizeof(type),s,e)
+        Simd::interp((Scalar*)&fF[s],(const Scalar*)&cF[0],&FO[0] + s,&FN[0] + s,
+                     &fI[s],e - s,MeshField<type,CELL>::TYPE_SIZE);
+}
 /** central difference scheme */
 template<class type>
 MeshField<type,FACET> cds(const MeshField<type,CELL>& cF) {
-    using namespace Mesh;
     MeshField<type,FACET> fF;
-    forEach(fF,i) {
-        fF[i] =  (cF[FO[i]] * (fI[i])) + (cF[FN[i]] * (1 - fI[i]));
-    }
+    cds(fF,cF);
     return fF;
 }
 
@@ -893,7 +1079,7 @@ template<class type,class T3>
 MeshField<type,FACET> uds(const MeshField<type,CELL>& cF,const MeshField<T3,FACET>& flux) {
     using namespace Mesh;
     MeshField<type,FACET> fF;
-    forEach(fF,i) {
+    forEachP(fF,i) {
         if(dot(flux[i],T3(1)) >= 0) fF[i] = cF[FO[i]];
         else fF[i] = cF[FN[i]];
     }
@@ -916,8 +1102,8 @@ MeshField<type,VERTEX> cds(const MeshField<type,FACET>& fF) {
     vF = type(0);
 
     forEach(fF,i) {
-        Facet& f = gFacets[i];
-        if(FN[i] < gBCSfield) {
+        Compressed::Row f = gFaceVertices[i];
+        if(FN[i] < gHCSfield) {
             forEach(f,j) {
                 Scalar dist = Scalar(1.0) / magSq(gVertices[f[j]] - fC[i]);
                 vF[f[j]] += (fF[i] * dist);
@@ -940,16 +1126,66 @@ MeshField<type,VERTEX> cds(const MeshField<type,FACET>& fF) {
     return vF;
 }
 
-/** Integrate field operation */
+/** Integrate field operation adding to an existing field */
 template<class type>
-MeshField<type,CELL> sum(const MeshField<type,FACET>& fF) {
+void sum(MeshField<type,CELL>& cF,const MeshField<type,FACET>& fF) {
     using namespace Mesh;
-    MeshField<type,CELL> cF;
-    cF = type(0);
-    forEach(fF,i) {
+    forEachFaceP(i) {
         cF[FO[i]] += fF[i];
         cF[FN[i]] -= fF[i];
     }
+}
+
+template<class type, class A>
+void sum(MeshField<type,CELL>& cF,const DVExpr<type,A>& expr) {
+    sum(cF,MeshField<type,FACET>(expr));
+}
+
+/** Integrate a face expression in one face loop without a facet field */
+#define SUM_FACES_C(r,type,f,c1,c2,expr) {          \
+    r = type(0);                                    \
+    if(Mesh::structuredFaces()) {                   \
+        forEachFaceRun(f,c1,c2) {                   \
+            type v_ = expr;                         \
+            r[c1] += v_;                            \
+            r[c2] -= v_;                            \
+        }                                           \
+    } else {                                        \
+        forEachFaceP(f) {                           \
+            Int c1 = Mesh::FO[f], c2 = Mesh::FN[f]; \
+            type v_ = expr;                         \
+            r[c1] += v_;                            \
+            r[c2] -= v_;                            \
+        }                                           \
+    }                                               \
+}
+#define SUM_FACES(r,type,f,expr)                    \
+    SUM_FACES_C(r,type,f,c1_,c2_,expr)
+
+/** Add a face expression over faces of groups [g0,g1) */
+#define SUM_FACES_IN(r,type,g0,g1,f,c1,c2,expr) {   \
+    if(Mesh::structuredFaces()) {                   \
+        forEachFaceRunIn(g0,g1,f,c1,c2) {           \
+            type v_ = expr;                         \
+            r[c1] += v_;                            \
+            r[c2] -= v_;                            \
+        }                                           \
+    } else {                                        \
+        forEachFaceInP(g0,g1,f) {                   \
+            Int c1 = Mesh::FO[f], c2 = Mesh::FN[f]; \
+            type v_ = expr;                         \
+            r[c1] += v_;                            \
+            r[c2] -= v_;                            \
+        }                                           \
+    }                                               \
+}
+
+/** Integrate field operation */
+template<class type>
+MeshField<type,CELL> sum(const MeshField<type,FACET>& fF) {
+    MeshField<type,CELL> cF;
+    cF = type(0);
+    sum(cF,fF);
     return cF;
 }
 
@@ -1141,7 +1377,7 @@ void MeshField<T,E>::writeInternal(std::ostream& os, IntVector* cMap) {
     if(cMap)
         size = cMap->size();
     else
-        size = (SIZE == gCells.size() * DG::NP) ? gBCSfield : SIZE;
+        size = (SIZE == gCellFaces.size() * DG::NP) ? gBCSfield : SIZE;
     os << size << std::endl;
     os << "{" << std::endl;
     for(Int i = 0;i < size;i++) {
@@ -1208,6 +1444,19 @@ struct MeshMatrix {
     enum FLAG {
         SYMMETRIC = 1, DIAGONAL = 2
     };
+    /*symmetric matrices keep one off-diagonal array*/
+    bool isShared() const {
+        return an[1].shares(an[0]);
+    }
+    void share() {
+        an[1].share(an[0]);
+    }
+    void unshare(bool copy = true) {
+        if(isShared()) {
+            an[1].allocate();
+            if(copy) an[1] = an[0];
+        }
+    }
     /*c'tors*/
     MeshMatrix() {
         cF = 0;
@@ -1218,16 +1467,26 @@ struct MeshMatrix {
         flags = p.flags;
         ap = p.ap;
         an[0] = p.an[0];
-        an[1] = p.an[1];
+        if(p.isShared()) share();
+        else an[1] = p.an[1];
         Su = p.Su;
         adg = p.adg;
     }
+#if __cplusplus >= 201103L
+    MeshMatrix(MeshMatrix&& p) : 
+        cF(p.cF), ap(std::move(p.ap)), 
+        an{std::move(p.an[0]),MeshField<T2,FACET>(false)},
+        adg(std::move(p.adg)), Su(std::move(p.Su)), flags(p.flags) {
+        if(p.an[1].shares(an[0])) share();
+        else an[1] = std::move(p.an[1]);
+    }
+#endif
     MeshMatrix(MeshField<T1,CELL>* pcF) {
         cF = pcF;
         flags = (SYMMETRIC | DIAGONAL);
         ap = T2(0);
         an[0] = T2(0);
-        an[1] = T2(0);
+        share();
         Su = T3(0);
         adg = T2(0);
     }
@@ -1237,18 +1496,27 @@ struct MeshMatrix {
         flags = (SYMMETRIC | DIAGONAL);
         ap = T2(0);
         an[0] = T2(0);
-        an[1] = T2(0);
+        share();
         Su = p;
         adg = T2(0);
     }
     /*operators*/
+#if __cplusplus >= 201103L
+    MeshMatrix operator - () && {
+        *this *= Scalar(-1);
+        return std::move(*this);
+    }
+    MeshMatrix operator - () & {
+#else
     MeshMatrix operator - () {
+#endif
         MeshMatrix r;
         r.cF = cF;
         r.flags = flags;
         r.ap = -ap;
         r.an[0] = -an[0];
-        r.an[1] = -an[1];
+        if(isShared()) r.share();
+        else r.an[1] = -an[1];
         r.Su = -Su;
         r.adg = -adg;
         return r;
@@ -1258,33 +1526,71 @@ struct MeshMatrix {
         flags = q.flags;
         ap = q.ap;
         an[0] = q.an[0];
-        an[1] = q.an[1];
+        if(q.isShared()) share();
+        else {
+            unshare(false);
+            an[1] = q.an[1];
+        }
         Su = q.Su;
         adg = q.adg;
         return *this;
     }
+#if __cplusplus >= 201103L
+    MeshMatrix& operator = (MeshMatrix&& q) {
+        bool shared = q.isShared();
+        cF = q.cF;
+        flags = q.flags;
+        ap = std::move(q.ap);
+        an[0] = std::move(q.an[0]);
+        if(shared) share();
+        else {
+            unshare(false);
+            an[1] = std::move(q.an[1]);
+        }
+        Su = std::move(q.Su);
+        adg = std::move(q.adg);
+        return *this;
+    }
+#endif
     MeshMatrix& operator += (const MeshMatrix& q) {
+        bool shared = isShared() && q.isShared();
+        if(!shared) unshare();
         flags &= q.flags;
         ap += q.ap;
         an[0] += q.an[0];
-        an[1] += q.an[1];
+        if(!shared) an[1] += q.an[1];
         Su += q.Su;
         adg += q.adg;
         return *this;
     }
     MeshMatrix& operator -= (const MeshMatrix& q) {
+        bool shared = isShared() && q.isShared();
+        if(!shared) unshare();
         flags &= q.flags;
         ap -= q.ap;
         an[0] -= q.an[0];
-        an[1] -= q.an[1];
+        if(!shared) an[1] -= q.an[1];
         Su -= q.Su;
         adg -= q.adg;
         return *this;
     }
+    /*a source field is a diagonal matrix with only Su*/
+    template<class A>
+    MeshMatrix& operator += (const DVExpr<T3,A>& q) {
+        flags &= (SYMMETRIC | DIAGONAL);
+        Su += q;
+        return *this;
+    }
+    template<class A>
+    MeshMatrix& operator -= (const DVExpr<T3,A>& q) {
+        flags &= (SYMMETRIC | DIAGONAL);
+        Su -= q;
+        return *this;
+    }
     MeshMatrix& operator *= (const Scalar& q) {
         ap *= q;
         an[0] *= q;
-        an[1] *= q;
+        if(!isShared()) an[1] *= q;
         Su *= q;
         adg *= q;
         return *this;
@@ -1292,7 +1598,7 @@ struct MeshMatrix {
     MeshMatrix& operator /= (const Scalar& q) {
         ap /= q;
         an[0] /= q;
-        an[1] /= q;
+        if(!isShared()) an[1] /= q;
         Su /= q;
         adg /= q;
         return *this;
@@ -1301,12 +1607,48 @@ struct MeshMatrix {
     AddOperator(MeshMatrix,+);
     AddOperator(MeshMatrix,-);
     AddScalarOperators(MeshMatrix)
+#if __cplusplus >= 201103L
+    /*binary ops on a temporary work in place*/
+    friend MeshMatrix operator + (MeshMatrix&& p,const MeshMatrix& q) {
+        p += q;
+        return std::move(p);
+    }
+    friend MeshMatrix operator - (MeshMatrix&& p,const MeshMatrix& q) {
+        p -= q;
+        return std::move(p);
+    }
+    friend MeshMatrix operator * (MeshMatrix&& p,const Scalar& q) {
+        p *= q;
+        return std::move(p);
+    }
+    friend MeshMatrix operator / (MeshMatrix&& p,const Scalar& q) {
+        p /= q;
+        return std::move(p);
+    }
+#endif
     /*is equal to*/
     friend MeshMatrix operator == (const MeshMatrix& p,const MeshMatrix& q) {
         MeshMatrix r = p;
         r -= q;
         return r;
     }
+    template<class A>
+    friend MeshMatrix operator == (const MeshMatrix& p,const DVExpr<T3,A>& q) {
+        MeshMatrix r = p;
+        r -= q;
+        return r;
+    }
+#if __cplusplus >= 201103L
+    friend MeshMatrix operator == (MeshMatrix&& p,const MeshMatrix& q) {
+        p -= q;
+        return std::move(p);
+    }
+    template<class A>
+    friend MeshMatrix operator == (MeshMatrix&& p,const DVExpr<T3,A>& q) {
+        p -= q;
+        return std::move(p);
+    }
+#endif
     /*relax*/
     void Relax(Scalar UR) {
         ap /= UR;
@@ -1328,6 +1670,7 @@ struct MeshMatrix {
         return os;
     }
     friend std::istream& operator >> (std::istream& is, MeshMatrix& p) {
+        p.unshare(false);
         is >> p.ap;
         is >> p.an[0];
         is >> p.an[1];
@@ -1355,41 +1698,122 @@ class ASYNC_COMM {
 private:
     T* P;
     Int rcount;
+    bool reduced;
     std::vector<MP::REQUEST> request;
-    MeshField<T,CELL> recvbuf;
+    std::vector<T> sendbuf;
+    std::vector<T> recvbuf;
+    std::vector<float> sendbuf_r;
+    std::vector<float> recvbuf_r;
 public:
-    ASYNC_COMM(T* p) : P(p)
+    ASYNC_COMM(T* p) : P(p), reduced(false)
     {
     }
-    void send() {
+    /** Number of values sent across inter-processor boundary */
+    static Int send_size(const Mesh::interBoundary& b) {
+        if(b.sc.size()) 
+            return b.sc.size();
+        return b.f->size() * DG::NPF;
+    }
+    /** Number of values recieved across inter-processor boundary */
+    static Int recv_size(const Mesh::interBoundary& b) {
+        return b.hc.size() + b.f->size() * DG::NPF;
+    }
+    /** Fill buffer with values to send */
+    static void pack(const T* P, const Mesh::interBoundary& b, T* buf) {
+        using namespace Mesh;
+        using namespace DG;
+        
+        if(b.sc.size()) {
+            forEach(b.sc,j)
+                buf[j] = P[b.sc[j]];
+            return;
+        }
+        IntVector& f = *(b.f);
+        if(NPF == 1) {
+            forEach(f,j)
+                buf[j] = P[FO[f[j]]];
+            return;
+        }
+        forEach(f,j) {
+            Int faceid = f[j];
+            for(Int n = 0; n < NPF;n++) {
+                Int k = faceid * NPF + n;
+                buf[j * NPF + n] = P[FO[k]]; 
+            }                                                           
+        }
+    }
+    /** Copy recieved values to halo and ghost cells */
+    static void unpack(T* P, const Mesh::interBoundary& b, const T* buf) {
+        using namespace Mesh;
+        using namespace DG;
+        
+        forEach(b.hc,j)
+            P[b.hc[j]] = buf[j];
+        buf += b.hc.size();
+        IntVector& f = *(b.f);
+        if(NPF == 1) {
+            forEach(f,j)
+                P[FN[f[j]]] = buf[j];
+            return;
+        }
+        forEach(f,j) {
+            Int faceid = f[j];
+            for(Int n = 0; n < NPF;n++) {
+                Int k = faceid * NPF + n;
+                P[FN[k]] = buf[j * NPF + n]; 
+            }                                                           
+        }
+    }
+    /** Start exchange, optionally with values rounded to single precision */
+    void send(const bool reduced_ = false) {
         using namespace Mesh;
         using namespace DG;
+        const Int R = sizeof(T) / sizeof(Scalar);
+        reduced = reduced_;
+        
+        //---allocate buffers
+        if(gInterMesh.size()) {
+            interBoundary& b = gInterMesh.back();
+            sendbuf.resize(b.send_index * NPF + send_size(b));
+            recvbuf.resize(b.buffer_index * NPF + recv_size(b));
+            if(reduced) {
+                sendbuf_r.resize(sendbuf.size() * R);
+                recvbuf_r.resize(recvbuf.size() * R);
+            }
+        }
         
         //---fill send buffer and send
-        MeshField<T,CELL> sendbuf;
         request.assign(2 * Mesh::gInterMesh.size(),0);
         rcount = 0;
         forEach(gInterMesh,i) {
             interBoundary& b = gInterMesh[i];
-            IntVector& f = *(b.f);
-            Int buf_size = f.size() * NPF;
+            T* sbuf = &sendbuf[b.send_index * NPF];
+            T* rbuf = &recvbuf[b.buffer_index * NPF];
             
             //--fill send buffer
-            forEach(f,j) {
-                Int faceid = f[j];
-                for(Int n = 0; n < NPF;n++) {
-                    Int k = faceid * NPF + n;
-                    sendbuf[(b.buffer_index + j) * NPF + n] = P[FO[k]]; 
-                }                                                           
-            }   
+            pack(P,b,sbuf);
 
             //--non-blocking send/recive
-            MP::isend(&sendbuf[b.buffer_index * NPF],buf_size,
-                b.to,MP::FIELD_BLK,&request[rcount]);
-            rcount++;
-            MP::irecieve(&recvbuf[b.buffer_index * NPF],buf_size,
-                b.to,MP::FIELD_BLK,&request[rcount]);
-            rcount++;
+            if(reduced) {
+                const Scalar* s = (const Scalar*) sbuf;
+                float* sbuf_r = &sendbuf_r[b.send_index * NPF * R];
+                float* rbuf_r = &recvbuf_r[b.buffer_index * NPF * R];
+                for(Int j = 0;j < send_size(b) * R;j++)
+                    sbuf_r[j] = float(s[j]);
+                MP::isend(sbuf_r,send_size(b) * R,
+                    b.to,MP::FIELD_BLK,&request[rcount]);
+                rcount++;
+                MP::irecieve(rbuf_r,recv_size(b) * R,
+                    b.to,MP::FIELD_BLK,&request[rcount]);
+                rcount++;
+            } else {
+                MP::isend(sbuf,send_size(b),
+                    b.to,MP::FIELD_BLK,&request[rcount]);
+                rcount++;
+                MP::irecieve(rbuf,recv_size(b),
+                    b.to,MP::FIELD_BLK,&request[rcount]);
+                rcount++;
+            }
         }
     }
     void recv() {
@@ -1398,21 +1822,148 @@ public:
         
         MP::waitall(rcount,&request[0]);
         
+        //--widen reduced precision values
+        if(reduced) {
+            Scalar* r = (Scalar*) &recvbuf[0];
+            forEach(recvbuf_r,j)
+                r[j] = Scalar(recvbuf_r[j]);
+        }
+        
         //--copy from buffer to ghost cells
         forEach(gInterMesh,i) {
             interBoundary& b = gInterMesh[i];
-            IntVector& f = *(b.f);
-
-            forEach(f,j) {
-                Int faceid = f[j];
-                for(Int n = 0; n < NPF;n++) {
-                    Int k = faceid * NPF + n;
-                    P[FN[k]] = recvbuf[(b.buffer_index + j) * NPF + n]; 
-                }                                                           
-            }
+            unpack(P,b,&recvbuf[b.buffer_index * NPF]);
         }
     }
 };
+/**
+Class for asynchronous communication using one-sided MPI. Each
+processor puts its boundary values directly into windows of its 
+neighbors and reads its own window whenever it wants, so there is
+no need to match messages.
+*/
+template <class T>
+class ASYNC_RMA {
+private:
+    MP::WINDOW win;
+    std::vector<Scalar> window;     /**< stamps followed by recieve buffer */
+    std::vector<T> sendbuf;
+    std::vector<Scalar> stamps;     /**< last stamp read from each patch */
+    std::vector<Scalar> remote;     /**< stamp & buffer location in neighbor */
+    Scalar stamp;
+    Scalar vote[3],gvote[3];        /**< unconverged, sent & recieved puts */
+    Scalar sent;                    /**< puts sent in the last quiet round */
+    MP::REQUEST request;
+    bool pending;
+    bool quiet;
+    bool enabled;
+public:
+    ASYNC_RMA(bool enable = true) : stamp(0), sent(-1), pending(false),
+        quiet(false), enabled(enable)
+    {
+        using namespace Mesh;
+        using namespace DG;
+        const Int R = sizeof(T) / sizeof(Scalar);
+        const Int N = gInterMesh.size();
+        if(!enabled)
+            return;
+        
+        //---allocate buffers
+        Int size = N;
+        if(N) {
+            interBoundary& b = gInterMesh.back();
+            sendbuf.resize(b.send_index * NPF + ASYNC_COMM<T>::send_size(b));
+            size += (b.buffer_index * NPF + ASYNC_COMM<T>::recv_size(b)) * R;
+        }
+        window.assign(size,Scalar(0));
+        stamps.assign(N,Scalar(0));
+        MP::win_create(N ? &window[0] : 0,size,&win);
+        
+        //---exchange location of stamp & recieve buffer with neighbors
+        std::vector<Scalar> local(2 * N);
+        std::vector<MP::REQUEST> req(2 * N);
+        remote.resize(2 * N);
+        forEach(gInterMesh,i) {
+            interBoundary& b = gInterMesh[i];
+            local[2 * i + 0] = i;
+            local[2 * i + 1] = N + b.buffer_index * NPF * R;
+            MP::isend(&local[2 * i],2,b.to,MP::FIELD,&req[2 * i]);
+            MP::irecieve(&remote[2 * i],2,b.to,MP::FIELD,&req[2 * i + 1]);
+        }
+        if(N) MP::waitall(2 * N,&req[0]);
+    }
+    ~ASYNC_RMA() {
+        if(!enabled)
+            return;
+        if(pending) MP::waitall(1,&request);
+        MP::win_free(&win);
+    }
+    /** Put boundary values into neighbors' windows */
+    void put(const T* P) {
+        using namespace Mesh;
+        using namespace DG;
+        
+        stamp += 1;
+        forEach(gInterMesh,i) {
+            interBoundary& b = gInterMesh[i];
+            T* sbuf = &sendbuf[b.send_index * NPF];
+            ASYNC_COMM<T>::pack(P,b,sbuf);
+            MP::win_lock(b.to,false,win);
+            MP::put(sbuf,ASYNC_COMM<T>::send_size(b),
+                b.to,Int(remote[2 * i + 1]),win);
+            MP::put(&stamp,1,b.to,Int(remote[2 * i]),win);
+            MP::win_unlock(b.to,win);
+        }
+    }
+    /** Copy values that arrived since the last call to ghost cells */
+    bool get(T* P) {
+        using namespace Mesh;
+        using namespace DG;
+        const Int R = sizeof(T) / sizeof(Scalar);
+        const Int N = gInterMesh.size();
+        
+        bool updated = false;
+        MP::win_lock(MP::host_id,true,win);
+        forEach(gInterMesh,i) {
+            if(window[i] == stamps[i])
+                continue;
+            interBoundary& b = gInterMesh[i];
+            T* rbuf = (T*) &window[N + b.buffer_index * NPF * R];
+            ASYNC_COMM<T>::unpack(P,b,rbuf);
+            stamps[i] = window[i];
+            updated = true;
+        }
+        MP::win_unlock(MP::host_id,win);
+        return updated;
+    }
+    /** 
+    Distributed termination detection. Rounds of non-blocking reductions
+    of the number of unconverged processors and of the puts sent and
+    recieved are started one after another. A round is quiet when all 
+    processors have converged and all puts have been read. Processors stop 
+    after two quiet rounds with the same number of puts, since a vote 
+    may be taken before values that are still in flight arrive.
+    */
+    bool terminated(bool converged) {
+        if(!pending) {
+            vote[0] = (converged ? 0 : 1);
+            vote[1] = stamp * Mesh::gInterMesh.size();
+            vote[2] = 0;
+            forEach(stamps,i)
+                vote[2] += stamps[i];
+            MP::iallreduce(vote,gvote,3,MP::OP_SUM,&request);
+            pending = true;
+        }
+        if(!MP::test(&request))
+            return false;
+        pending = false;
+        bool was_quiet = quiet;
+        quiet = (gvote[0] == 0 && gvote[1] == gvote[2]);
+        bool done = (quiet && was_quiet && gvote[1] == sent);
+        sent = gvote[1];
+        return done;
+    }
+};
 /* ********************************
  *  Tenosor-Product approach
  * ********************************/
@@ -1454,37 +2005,53 @@ public:
  * matrix - vector products
  * *******************************/
 
+/** diagonal - vector product */
+template <class T1, class T2> 
+void mulDiag(MeshField<T1,CELL>& r,const MeshField<T1,CELL>& q,const MeshField<T2,CELL>& ap) {
+    r = q * ap;
+}
+template <class T1> 
+void mulDiag(MeshField<T1,CELL>& r,const MeshField<T1,CELL>& q,const MeshField<Scalar,CELL>& ap) {
+    forChunkP(r.size(),sizeof(T1),s,e)
+        Simd::scale((Scalar*)&r[s],(const Scalar*)&q[s],&ap[s],
+                    e - s,MeshField<T1,CELL>::TYPE_SIZE);
+}
 /** matrix - vector product = A * x */
 template <class T1, class T2, class T3> 
-MeshField<T1,CELL> mul (const MeshMatrix<T1,T2,T3>& p,const MeshField<T1,CELL>& q, const bool sync = false) {
+MeshField<T1,CELL> mul (const MeshMatrix<T1,T2,T3>& p,const MeshField<T1,CELL>& q, 
+                        const bool sync = false, const bool reduced = false) {
     using namespace Mesh;
     using namespace DG;
     MeshField<T3,CELL> r;
-    Int c1,c2;
     ASYNC_COMM<T1> comm(&q[0]);
     
-    if(sync) comm.send();
+    if(sync) comm.send(reduced);
     
-    r = q * p.ap;
+    mulDiag(r,q,p.ap);
     
     if(NPMAT) {
         TensorProduct(q,p);
     }
     
-    forEach(FN,f) {
-        c2 = FN[f];
-        if(c2 >= gBCSfield) continue;
-        c1 = FO[f];
-        r[c1] -= q[c2] * p.an[1][f];
-        r[c2] -= q[c1] * p.an[0][f];
+    if(structuredFaces()) {
+        forEachInteriorFaceRun(f,c1,c2) {
+            r[c1] -= q[c2] * p.an[1][f];
+            r[c2] -= q[c1] * p.an[0][f];
+        }
+    } else {
+        forEachInteriorFaceP(f) {
+            Int c1 = FO[f];
+            Int c2 = FN[f];
+            r[c1] -= q[c2] * p.an[1][f];
+            r[c2] -= q[c1] * p.an[0][f];
+        }
     }
     
     if(sync) comm.recv();
     
-    forEach(FN,f) {
-        c2 = FN[f];
-        if(c2 < gBCSfield) continue;
-        c1 = FO[f];
+    forEachHaloFaceP(f) {
+        Int c1 = FO[f];
+        Int c2 = FN[f];
         r[c1] -= q[c2] * p.an[1][f];
     }
     
@@ -1492,41 +2059,47 @@ MeshField<T1,CELL> mul (const MeshMatrix<T1,T2,T3>& p,const MeshField<T1,CELL>&
 }
 
 template <class T1, class T2, class T3, class A> 
-MeshField<T1,CELL> mul (const MeshMatrix<T1,T2,T3>& p,const DVExpr<T1,A>& q, const bool sync = false) {
-    return mul(p,MeshField<T1,CELL>(q),sync);
+MeshField<T1,CELL> mul (const MeshMatrix<T1,T2,T3>& p,const DVExpr<T1,A>& q, 
+                        const bool sync = false, const bool reduced = false) {
+    return mul(p,MeshField<T1,CELL>(q),sync,reduced);
 }
 
 /** matrix transopose - vector product = A^T * x */
 template <class T1, class T2, class T3> 
-MeshField<T1,CELL> mult (const MeshMatrix<T1,T2,T3>& p,const MeshField<T1,CELL>& q, const bool sync = false) {
+MeshField<T1,CELL> mult (const MeshMatrix<T1,T2,T3>& p,const MeshField<T1,CELL>& q, 
+                        const bool sync = false, const bool reduced = false) {
     using namespace Mesh;
     using namespace DG;
     MeshField<T3,CELL> r;
-    Int c1,c2;
     ASYNC_COMM<T1> comm(&q[0]);
     
-    if(sync) comm.send();
+    if(sync) comm.send(reduced);
     
-    r = q * p.ap;
+    mulDiag(r,q,p.ap);
     
     if(NPMAT) {
         TensorProductT(q,p);
     }
     
-    forEach(FN,f) {
-        c2 = FN[f];
-        if(c2 >= gBCSfield) continue;
-        c1 = FO[f];
-        r[c2] -= q[c1] * p.an[1][f];
-        r[c1] -= q[c2] * p.an[0][f];
+    if(structuredFaces()) {
+        forEachInteriorFaceRun(f,c1,c2) {
+            r[c2] -= q[c1] * p.an[1][f];
+            r[c1] -= q[c2] * p.an[0][f];
+        }
+    } else {
+        forEachInteriorFaceP(f) {
+            Int c1 = FO[f];
+            Int c2 = FN[f];
+            r[c2] -= q[c1] * p.an[1][f];
+            r[c1] -= q[c2] * p.an[0][f];
+        }
     }
     
     if(sync) comm.recv();
     
-    forEach(FN,f) {
-        c2 = FN[f];
-        if(c2 < gBCSfield) continue;
-        c1 = FO[f];
+    forEachHaloFaceP(f) {
+        Int c1 = FO[f];
+        Int c2 = FN[f];
         r[c1] -= q[c2] * p.an[0][f];
     }
     
@@ -1534,15 +2107,15 @@ MeshField<T1,CELL> mult (const MeshMatrix<T1,T2,T3>& p,const MeshField<T1,CELL>&
 }
 /** calculate right-hand-side sum = b - (L + U) * x */
 template <class T1, class T2, class T3> 
-MeshField<T1,CELL> getRHS(const MeshMatrix<T1,T2,T3>& p, const bool sync = false) {
+MeshField<T1,CELL> getRHS(const MeshMatrix<T1,T2,T3>& p, 
+                        const bool sync = false, const bool reduced = false) {
     using namespace Mesh;
     using namespace DG;
     MeshField<T3,CELL> r;
     MeshField<T1,CELL>& q = (*p.cF);
-    Int c1,c2;
     ASYNC_COMM<T1> comm(&q[0]);
     
-    if(sync) comm.send();
+    if(sync) comm.send(reduced);
     
     r = p.Su;
     
@@ -1550,20 +2123,25 @@ MeshField<T1,CELL> getRHS(const MeshMatrix<T1,T2,T3>& p, const bool sync = false
         TensorProductM(q,p);
     }
     
-    forEach(FN,f) {
-        c2 = FN[f];
-        if(c2 >= gBCSfield) continue;
-        c1 = FO[f];
-        r[c1] += q[c2] * p.an[1][f];
-        r[c2] += q[c1] * p.an[0][f];
+    if(structuredFaces()) {
+        forEachInteriorFaceRun(f,c1,c2) {
+            r[c1] += q[c2] * p.an[1][f];
+            r[c2] += q[c1] * p.an[0][f];
+        }
+    } else {
+        forEachInteriorFaceP(f) {
+            Int c1 = FO[f];
+            Int c2 = FN[f];
+            r[c1] += q[c2] * p.an[1][f];
+            r[c2] += q[c1] * p.an[0][f];
+        }
     }
     
     if(sync) comm.recv();
     
-    forEach(FN,f) {
-        c2 = FN[f];
-        if(c2 < gBCSfield) continue;
-        c1 = FO[f];
+    forEachHaloFaceP(f) {
+        Int c1 = FO[f];
+        Int c2 = FN[f];
         r[c1] += q[c2] * p.an[1][f];
     }
     
@@ -1672,7 +2250,7 @@ void applyExplicitBCs(const MeshField<T,E>& cF,
                             zmax = -Scalar(10e30);
                             C = Vector(0);
                             for(Int j = 0;j < sz;j++) {
-                                Facet& f = gFacets[j];
+                                Compressed::Row f = gFaceVertices[j];
                                 Vector fc(Scalar(0));
                                 forEach(f,k) {
                                     fc += vC[f[k]];
@@ -1688,10 +2266,10 @@ void applyExplicitBCs(const MeshField<T,E>& cF,
                             zR = zmax - zmin;
 
                             if(bc->cIndex == PARABOLIC) {
-                                Int vi = gFacets[(*bc->bdry)[0]][0];
+                                Int vi = gFaceVertices[(*bc->bdry)[0]][0];
                                 zR = magSq(vC[vi] - C);
                                 for(Int j = 1;j < sz;j++) {
-                                    vi = gFacets[(*bc->bdry)[j]][0];
+                                    vi = gFaceVertices[(*bc->bdry)[j]][0];
                                     Scalar r = magSq(vC[vi] - C);
                                     if(r < zR) zR = r;
                                 }
@@ -1772,15 +2350,28 @@ void applyExplicitBCs(const MeshField<T,E>& cF,
     if(sync) comm.recv();
 }
 
-/** Fill boundary values from internals */
+/** Does a fill exchange halo values. A local fill skips the exchange
+ *  when halo cells are deep enough (ghost depth 2) to hold correct values */
+inline bool fillExchanges(const bool local) {
+    using namespace Mesh;
+    return gInterMesh.size() && !(local && gHCS > gBCS);
+}
+/** Fill values of physical boundary cells from internals */
 template<class T>
-const MeshField<T,CELL>& fillBCs(const MeshField<T,CELL>& cF, const bool sync = false, const Int bind = 0) {
+void fillBoundaryCells(const MeshField<T,CELL>& cF, const Int bind = 0) {
     using namespace Mesh;
-    forEachS(gCells,i,gBCS) {
-        Int faceid = gCells[i][0];
-        for(Int n = 0; n < DG::NPF;n++) {
-            Int k = faceid * DG::NPF + n;
-            cF[FN[k]] = cF[FO[k]];
+    if(DG::NPF == 1) {
+        forEachS(gCellFaces,i,gHCS) {
+            Int f = gCellFaces[i][0];
+            cF[FN[f]] = cF[FO[f]];
+        }
+    } else {
+        forEachS(gCellFaces,i,gHCS) {
+            Int faceid = gCellFaces[i][0];
+            for(Int n = 0; n < DG::NPF;n++) {
+                Int k = faceid * DG::NPF + n;
+                cF[FN[k]] = cF[FO[k]];
+            }
         }
     }
     
@@ -1806,8 +2397,13 @@ const MeshField<T,CELL>& fillBCs(const MeshField<T,CELL>& cF, const bool sync =
             }
         }
     }
-    
-    if(gInterMesh.size()) {
+}
+/** Fill boundary values from internals and exchange halo values */
+template<class T>
+const MeshField<T,CELL>& fillBCs(const MeshField<T,CELL>& cF, const bool sync = false, 
+                                 const Int bind = 0, const bool local = false) {
+    fillBoundaryCells(cF,bind);
+    if(fillExchanges(local)) {
         ASYNC_COMM<T> comm(&cF[0]);
         comm.send();
         comm.recv();
@@ -1829,7 +2425,7 @@ MeshMatrix<T1,T2,T3> src(MeshField<T1,CELL>& cF,const MeshField<T3,CELL>& Su, co
     //others
     m.adg = Scalar(0);
     m.an[0] = Scalar(0);
-    m.an[1] = Scalar(0);
+    m.share();
     return m;
 }
 
@@ -1854,16 +2450,9 @@ MeshField<type,CELL> srcf(const MeshField<type,CELL>& Su) {
     r[index1] -= mul(dpsi_ij,p[index]);             \
 }
 
-#define GRAD(T1,T2)                                                                         \
-inline MeshField<T1,CELL> gradf(const MeshField<T2,CELL>& p) {                              \
-    using namespace Mesh;                                                                   \
-    using namespace DG;                                                                     \
-    MeshField<T1,CELL> r;                                                                   \
-                                                                                            \
-    r = sum(mul(fN,cds(p)));                                                                \
-                                                                                            \
+#define GRADV(cs,ce) {                                                                      \
     if(NPMAT) {                                                                             \
-        for(Int ci = 0; ci < gBCS;ci++) {                                                   \
+        for(Int ci = cs; ci < ce;ci++) {                                                    \
             forEachLgl(ii,jj,kk) {                                                          \
                 Int index = INDEX4(ci,ii,jj,kk);                                            \
                 Tensor Jin = Jinv[index] * cV[index];                                       \
@@ -1873,8 +2462,29 @@ inline MeshField<T1,CELL> gradf(const MeshField<T2,CELL>& p) {
             }                                                                               \
         }                                                                                   \
     }                                                                                       \
+}
+
+/*cells next to the halo and boundaries are computed first, so that their
+  values are sent while the inner cells are computed*/
+#define GRAD(T1,T2)                                                                         \
+inline MeshField<T1,CELL> gradf(const MeshField<T2,CELL>& p, const bool local = false) {    \
+    using namespace Mesh;                                                                   \
+    using namespace DG;                                                                     \
+    MeshField<T1,CELL> r;                                                                   \
+    ASYNC_COMM<T1> comm(&r[0]);                                                             \
+    const bool exch = fillExchanges(local), early = exch && gEarlySend;                     \
+                                                                                            \
+    r = T1(0);                                                                              \
+    SUM_FACES_IN(r,T1,INTERIOR_FACES,nFaceGroups(),f,c1,c2,mul(fN[f],cds(p,f,c1,c2)));      \
+    GRADV(gBCSI,gBCS);                                                                      \
+    if(early) comm.send();                                                                  \
                                                                                             \
-    fillBCs(r,false,p.fIndex);                                                              \
+    SUM_FACES_IN(r,T1,INNER_FACES,INTERIOR_FACES,f,c1,c2,mul(fN[f],cds(p,f,c1,c2)));        \
+    GRADV(0,gBCSI);                                                                         \
+                                                                                            \
+    fillBoundaryCells(r,p.fIndex);                                                          \
+    if(exch && !early) comm.send();                                                         \
+    if(exch) comm.recv();                                                                   \
                                                                                             \
     return r;                                                                               \
 }
@@ -1882,9 +2492,119 @@ inline MeshField<T1,CELL> gradf(const MeshField<T2,CELL>& p) {
 GRAD(Vector,Scalar);
 GRAD(Tensor,Vector);
 #undef GRAD
+#undef GRADV
 #undef GRADD
 
 #define gradi(x) (gradf(x)  / Mesh::cV)
+#define gradl(x) (gradf(x,true)  / Mesh::cV)
+
+/**
+ Deferred correction of higher order schemes at a face, i.e. the
+ difference of the face value from the upwind value
+ */
+template<class T1, class T2, class T4>
+T1 deferredCorrection(const MeshField<T1,CELL>& cF,const MeshField<T2,CELL>& gF,
+                      const MeshField<T4,FACET>& flux,const Int f) {
+    using namespace Controls;
+    using namespace Mesh;
+    
+    /*upwind and downwind cells*/
+    const bool up = (dot(flux[f],T4(1)) >= 0);
+    const Int C = up ? FO[f] : FN[f];
+    const Int D = (dot(T4(0)-flux[f],T4(1)) >= 0) ? FO[f] : FN[f];
+    const T2 g = gF[C] / cV[C];
+
+    if(convection_scheme == LUD) {
+        return dot(g,fC[f] - cC[C]);
+    } else if(convection_scheme == MUSCL) {
+        T1 corr = (  blend_factor  ) * (cds(cF,f) - cF[C]);
+        corr += (1 - blend_factor) * (dot(g,fC[f] - cC[C]));
+        return corr;
+    }
+    /*
+    TVD schemes
+    ~~~~~~~~~~~
+    Reference:
+        M.S Darwish and F Moukalled "TVD schemes for unstructured grids"
+        Versteeg and Malaskara
+    Description:
+        phi = phiU + psi(r) * [(phiD - phiC) * (1 - fi)]
+    Schemes
+        psi(r) = 0 =>UDS
+        psi(r) = 1 =>CDS
+    R is calculated as ratio of upwind and downwind gradient
+        r = phiDC / phiCU
+    Further modification to unstructured grid to better fit LUD scheme
+        r = (phiDC / phiCU) * (fi / (1 - fi))
+    */
+    /*calculate r*/
+    const Scalar G = up ? fI[f] : (1 - fI[f]);
+    const T1 phiDC = cF[D] - cF[C];
+    T1 phiCU;
+    /*Bruner's or Darwish way of calculating r*/
+    if(TVDbruner)
+        phiCU = 2 * (dot(g,fC[f] - cC[C]));
+    else
+        phiCU = 2 * (dot(g,cC[D] - cC[C])) - phiDC;
+    /*end*/
+    T1 r = (phiCU / phiDC) * (G / (1 - G));
+    if(equal(phiDC * (1 - G),T1(0)))
+        r = T1(0);
+
+    /*TVD schemes*/
+    T1 q;
+    switch(convection_scheme) {
+    case VANLEER:
+        q = (r+fabs(r)) / (1+r);
+        break;
+    case VANALBADA:
+        q = (r+r*r) / (1+r*r);
+        break;
+    case MINMOD:
+        q = max(T1(0),min(r,T1(1)));
+        break;
+    case SUPERBEE:
+        q = max(min(r,T1(2)),min(2*r,T1(1)));
+        q = max(q,T1(0));
+        break;
+    case SWEBY: {
+        Scalar beta = 2;
+        q = max(min(r,T1(beta)),min(beta*r,T1(1)));
+        q = max(q,T1(0));
+        break;
+    }
+    case QUICKL:
+        q = min(2*r,(3+r)/4);
+        q = min(q,T1(2));
+        q = max(q,T1(0));
+        break;
+    case UMIST:
+        q = min(2*r,(3+r)/4);
+        q = min(q,(1+3*r)/4);
+        q = min(q,T1(2));
+        q = max(q,T1(0));
+        break;
+    case QUICK:
+        q = (3+r)/4;
+        break;
+    case DDS:
+        q = T1(2);
+        break;
+    case FROMM:
+        q = (1+r)/2;
+        break;
+    default:
+        q = T1(0);
+        break;
+    }
+    return q * phiDC * (1 - G);
+}
+/** Deferred correction source integrated in one face loop */
+template<class T1, class T2, class T4>
+void deferredCorrection(MeshField<T1,CELL>& Su,const MeshField<T1,CELL>& cF,
+                        const MeshField<T2,CELL>& gF,const MeshField<T4,FACET>& flux) {
+    SUM_FACES(Su,T1,f,flux[f] * deferredCorrection(cF,gF,flux,f));
+}
 
 /**
  Compute numerical flux
@@ -1897,8 +2617,6 @@ void numericalFlux(MeshMatrix<T1,T2,T3>& m, const MeshField<T4,FACET>& flux, con
         
     /*compute surface integral*/
     MeshField<T1,CELL>& cF = *m.cF;
-    T4 F;
-    Scalar G;
     
     bool isImplicit = (
         convection_scheme == CDS ||
@@ -1907,36 +2625,30 @@ void numericalFlux(MeshMatrix<T1,T2,T3>& m, const MeshField<T4,FACET>& flux, con
         convection_scheme == HYBRID );
 
     if(isImplicit) {
-        ScalarFacetField gamma;
+        Scalar G0;
         if(convection_scheme == CDS) 
-            gamma = Scalar(1);
+            G0 = 1;
         else if(convection_scheme == UDS) 
-            gamma = Scalar(0);
+            G0 = 0;
         else if(convection_scheme == BLENDED) 
-            gamma = Scalar(blend_factor);
-        else if(!muc)
-            gamma = Scalar(1);
-        else if(convection_scheme == HYBRID) {
-            MeshField<T4,FACET> mu = cds(*muc);
-            forEach(gFacets,faceid) {
-                for(Int n = 0; n < NPF;n++) {
-                    Int k = faceid * NPF + n;
-                    //compare F and D
-                    T4 D = fD[k] * mu[k];
-                    F = flux[k];
-                    if(dot(F,T4(1)) < 0) {
-                        if(dot(F * fI[k] + D,T4(1)) >= 0) gamma[k] = 1;
-                        else gamma[k] = 0;
-                    } else {
-                        if(dot(F * (1 - fI[k]) - D,T4(1)) > 0) gamma[k] = 0;
-                        else gamma[k] = 1;
-                    }
+            G0 = blend_factor;
+        else
+            G0 = 1;
+        const bool hybrid = (convection_scheme == HYBRID && muc);
+        forEachFaceP(i) {
+            T4 F = flux[i];
+            Scalar G = G0;
+            if(hybrid) {
+                //compare F and D
+                T4 D = fD[i] * cds(*muc,i);
+                if(dot(F,T4(1)) < 0) {
+                    if(dot(F * fI[i] + D,T4(1)) >= 0) G = 1;
+                    else G = 0;
+                } else {
+                    if(dot(F * (1 - fI[i]) - D,T4(1)) > 0) G = 0;
+                    else G = 1;
                 }
             }
-        }
-        forEach(flux,i) {
-            F = flux[i];
-            G = gamma[i];
             m.an[0][i] = ((G) * (-F * (  fI[i]  )) + (1 - G) * (-max( F,T4(0))));
             m.an[1][i] = ((G) * ( F * (1 - fI[i])) + (1 - G) * (-max(-F,T4(0))));
             m.ap[FO[i]] += m.an[0][i];
@@ -1944,101 +2656,20 @@ void numericalFlux(MeshMatrix<T1,T2,T3>& m, const MeshField<T4,FACET>& flux, con
         }
     /*deferred correction*/
     } else {
-        forEach(flux,i) {
-            F = flux[i];
+        forEachFaceP(i) {
+            T4 F = flux[i];
             m.an[0][i] = -max( F,T4(0));
             m.an[1][i] = -max(-F,T4(0));
             m.ap[FO[i]] += m.an[0][i];
             m.ap[FN[i]] += m.an[1][i];
         }
 
-        MeshField<T1,FACET> corr;
         if(convection_scheme == CDSS) {
-            corr = cds(cF) - uds(cF,flux);
-        } else if(convection_scheme == LUD) {
-            VectorFacetField R = fC - uds(cC,flux);
-            corr = dot(uds(gradi(cF),flux),R);
-        } else if(convection_scheme == MUSCL) {
-            VectorFacetField R = fC - uds(cC,flux);
-            corr  = (  blend_factor  ) * (cds(cF) - uds(cF,flux));
-            corr += (1 - blend_factor) * (dot(uds(gradi(cF),flux),R));
+            SUM_FACES(m.Su,T1,f,flux[f] * 
+                (cds(cF,f) - cF[(dot(flux[f],T4(1)) >= 0) ? FO[f] : FN[f]]));
         } else {
-            /*
-            TVD schemes
-            ~~~~~~~~~~~
-            Reference:
-                M.S Darwish and F Moukalled "TVD schemes for unstructured grids"
-                Versteeg and Malaskara
-            Description:
-                phi = phiU + psi(r) * [(phiD - phiC) * (1 - fi)]
-            Schemes
-                psi(r) = 0 =>UDS
-                psi(r) = 1 =>CDS
-            R is calculated as ratio of upwind and downwind gradient
-                r = phiDC / phiCU
-            Further modification to unstructured grid to better fit LUD scheme
-                r = (phiDC / phiCU) * (fi / (1 - fi))
-            */
-            /*calculate r*/
-            MeshField<T1,FACET> q,r,phiDC,phiCU;
-            ScalarFacetField uFI;
-            {
-                MeshField<T4,FACET> nflux = T4(0)-flux;
-                phiDC = uds(cF,nflux) - uds(cF,flux);
-                forEach(phiDC,i) {
-                    if(dot(flux[i],T4(1)) >= 0) G = fI[i];
-                    else G = 1 - fI[i];
-                    uFI[i] = G;
-                }
-                /*Bruner's or Darwish way of calculating r*/
-                if(TVDbruner) {
-                    VectorFacetField R = fC - uds(cC,flux);
-                    phiCU = 2 * (dot(uds(gradi(cF),flux),R));
-                } else {
-                    VectorFacetField R = uds(cC,nflux) - uds(cC,flux);
-                    phiCU = 2 * (dot(uds(gradi(cF),flux),R)) - phiDC;
-                }
-                /*end*/
-            }
-            r = (phiCU / phiDC) * (uFI / (1 - uFI));
-            forEach(phiDC,i) {
-                if(equal(phiDC[i] * (1 - uFI[i]),T1(0)))
-                    r[i] = T1(0);
-            }
-            /*TVD schemes*/
-            if(convection_scheme == VANLEER) {
-                q = (r+fabs(r)) / (1+r);
-            } else if(convection_scheme == VANALBADA) {
-                q = (r+r*r) / (1+r*r);
-            } else if(convection_scheme == MINMOD) {
-                q = max(T1(0),min(r,T1(1)));
-            } else if(convection_scheme == SUPERBEE) {
-                q = max(min(r,T1(2)),min(2*r,T1(1)));
-                q = max(q,T1(0));
-            } else if(convection_scheme == SWEBY) {
-                Scalar beta = 2;
-                q = max(min(r,T1(beta)),min(beta*r,T1(1)));
-                q = max(q,T1(0));
-            } else if(convection_scheme == QUICKL) {
-                q = min(2*r,(3+r)/4);
-                q = min(q,T1(2));
-                q = max(q,T1(0));
-            } else if(convection_scheme == UMIST) {
-                q = min(2*r,(3+r)/4);
-                q = min(q,(1+3*r)/4);
-                q = min(q,T1(2));
-                q = max(q,T1(0));
-            } else if(convection_scheme == QUICK) {
-                q = (3+r)/4;
-            } else if(convection_scheme == DDS) {
-                q = 2;
-            } else if(convection_scheme == FROMM) {
-                q = (1+r)/2;
-            }
-            corr = q * phiDC * (1 - uFI);
-            /*end*/
+            deferredCorrection(m.Su,cF,gradf(cF,true),flux);
         }
-        m.Su = sum(flux * corr);
     }
 }
 
@@ -2112,19 +2743,9 @@ MeshMatrix<T1,T2,T2> grad(MeshField<T1,CELL>& cF,const MeshField<T1,CELL>& flux_
     r[index1] -= dot(p[index],dpsi_ij);             \
 }
 
-#define DIV(T1,T2)                                                                          \
-inline MeshField<T1,FACET> flx(const MeshField<T2,CELL>& p) {                               \
-    return dot(cds(p),Mesh::fN);                                                            \
-}                                                                                           \
-inline MeshField<T1,CELL> divf(const MeshField<T2,CELL>& p) {                               \
-    using namespace Mesh;                                                                   \
-    using namespace DG;                                                                     \
-    MeshField<T1,CELL> r;                                                                   \
-                                                                                            \
-    r = sum(dot(cds(p),fN));                                                                \
-                                                                                            \
+#define DIVV(cs,ce) {                                                                       \
     if(NPMAT) {                                                                             \
-        for(Int ci = 0; ci < gBCS;ci++) {                                                   \
+        for(Int ci = cs; ci < ce;ci++) {                                                    \
             forEachLgl(ii,jj,kk) {                                                          \
                 Int index = INDEX4(ci,ii,jj,kk);                                            \
                 Tensor Jin = Jinv[index] * cV[index];                                       \
@@ -2134,8 +2755,34 @@ inline MeshField<T1,CELL> divf(const MeshField<T2,CELL>& p) {
             }                                                                               \
         }                                                                                   \
     }                                                                                       \
+}
+
+/*split in the same way as the gradient*/
+#define DIV(T1,T2)                                                                          \
+inline MeshField<T1,FACET> flx(const MeshField<T2,CELL>& p) {                               \
+    MeshField<T1,FACET> r;                                                                  \
+    forEachP(r,f)                                                                           \
+        r[f] = dot(cds(p,f),Mesh::fN[f]);                                                   \
+    return r;                                                                               \
+}                                                                                           \
+inline MeshField<T1,CELL> divf(const MeshField<T2,CELL>& p) {                               \
+    using namespace Mesh;                                                                   \
+    using namespace DG;                                                                     \
+    MeshField<T1,CELL> r;                                                                   \
+    ASYNC_COMM<T1> comm(&r[0]);                                                             \
+    const bool exch = fillExchanges(false), early = exch && gEarlySend;                     \
+                                                                                            \
+    r = T1(0);                                                                              \
+    SUM_FACES_IN(r,T1,INTERIOR_FACES,nFaceGroups(),f,c1,c2,dot(cds(p,f,c1,c2),fN[f]));      \
+    DIVV(gBCSI,gBCS);                                                                       \
+    if(early) comm.send();                                                                  \
+                                                                                            \
+    SUM_FACES_IN(r,T1,INNER_FACES,INTERIOR_FACES,f,c1,c2,dot(cds(p,f,c1,c2),fN[f]));        \
+    DIVV(0,gBCSI);                                                                          \
                                                                                             \
-    fillBCs(r);                                                                             \
+    fillBoundaryCells(r);                                                                   \
+    if(exch && !early) comm.send();                                                         \
+    if(exch) comm.recv();                                                                   \
                                                                                             \
     return r;                                                                               \
 }
@@ -2143,6 +2790,7 @@ inline MeshField<T1,CELL> divf(const MeshField<T2,CELL>& p) {
 DIV(Scalar,Vector);
 DIV(Vector,Tensor);
 #undef DIV
+#undef DIVV
 #undef DIVD
     
 #define divi(x)  (divf(x)   / Mesh::cV)
@@ -2219,6 +2867,32 @@ MeshField<type,entity> lapf(MeshField<type,entity>& cF,const MeshField<Scalar,en
 
 #define lapi(x,y) (lapf(x,y)  / Mesh::cV)
 
+/** Limited non-orthogonal correction of the laplacian at a face,
+    given the diffusivity times the cell gradient */
+template<class type, class T2>
+inline type nonOrthoFace(const MeshMatrix<type>& m,const MeshField<type,CELL>& cF,
+                         const MeshField<T2,CELL>& G,const Int i) {
+    using namespace Mesh;
+    const FaceStencil s = faceStencil(i);
+    Vector dv = cC[s.n] - cC[s.o];
+    Vector K = s.fN - s.fD * dv;
+    type r = dot((G[s.o] * (s.fI)) + (G[s.n] * (1 - s.fI)),K);
+    type res = m.an[0][i] * (cF[s.n] - cF[s.o]);
+    if(mag(r) > Scalar(0.5) * mag(res)) 
+        r = Scalar(0.5) * res;
+    return r;
+}
+/** Non-orthogonal correction source of the laplacian */
+template<class type, class T2>
+void nonOrthoCorrection(MeshMatrix<type>& m,const MeshField<T2,CELL>& G) {
+    const MeshField<type,CELL>& cF = *m.cF;
+    SUM_FACES(m.Su,type,i,nonOrthoFace(m,cF,G,i));
+}
+template<class type, class T2, class A>
+void nonOrthoCorrection(MeshMatrix<type>& m,const DVExpr<T2,A>& G) {
+    nonOrthoCorrection(m,MeshField<T2,CELL>(G));
+}
+
 /**
 Implicit laplacian operator
 */
@@ -2235,23 +2909,34 @@ MeshMatrix<type> lap(MeshField<type,CELL>& cF,const ScalarCellField& muc, const
     m.Su = type(0);
     m.ap = Scalar(0);
     m.adg = Scalar(0);
+    m.share();
     
     /* diffusion or penalty term */
     {
-        ScalarFacetField mu = cds(muc);
-        forEach(fN,i) {
-            Int c1 = FO[i];
-            Int c2 = FN[i];
-            /*coefficients*/
-            if(penalty || !NPMAT) {
-                m.an[0][i] = fD[i] * mu[i];
-                m.an[1][i] = fD[i] * mu[i];
-            } else{
-                m.an[0][i] = mu[i];
-                m.an[1][i] = mu[i];
+        const bool useD = (penalty || !NPMAT);
+        if(structuredFaces()) {
+            forEachFaceRun(i,c1,c2) {
+                Scalar mu = (muc[c1] * (fI[i])) + (muc[c2] * (1 - fI[i]));
+                /*coefficients*/
+                if(useD) 
+                    m.an[0][i] = fD[i] * mu;
+                else
+                    m.an[0][i] = mu;
+                m.ap[c1]  += m.an[0][i];
+                m.ap[c2]  += m.an[0][i];
+            }
+        } else {
+            forEachFaceP(i) {
+                const FaceStencil s = faceStencil(i);
+                Scalar mu = (muc[s.o] * (s.fI)) + (muc[s.n] * (1 - s.fI));
+                /*coefficients*/
+                if(useD) 
+                    m.an[0][i] = s.fD * mu;
+                else
+                    m.an[0][i] = mu;
+                m.ap[s.o]  += m.an[0][i];
+                m.ap[s.n]  += m.an[0][i];
             }
-            m.ap[c1]  += m.an[0][i];
-            m.ap[c2]  += m.an[1][i];
         }
     }
     
@@ -2309,30 +2994,13 @@ MeshMatrix<type> lap(MeshField<type,CELL>& cF,const ScalarCellField& muc, const
 
         /* compute explicit term */
         {
-            m.Su += sum(dot(cds(muc * gradi(cF)),fN));
+            sum(m.Su,dot(cds(muc * gradl(cF)),fN));
         }
         
     } else {
         /*non-orthogonality*/
-        if(nonortho_scheme != NONE) {
-            VectorFacetField K;
-            forEach(fN,i) {
-                Int c1 = FO[i];
-                Int c2 = FN[i];
-                Vector dv = cC[c2] - cC[c1];
-                K[i] = fN[i] - fD[i] * dv;
-            }
-            
-            MeshField<type,FACET> r = dot(cds(muc * gradi(cF)),K);
-            forEach(r,i) {
-                Int c1 = FO[i];
-                Int c2 = FN[i];
-                type res = m.an[0][i] * (cF[c2] - cF[c1]);
-                if(mag(r[i]) > Scalar(0.5) * mag(res)) 
-                    r[i] = Scalar(0.5) * res;
-            }
-            m.Su = sum(r);
-        }
+        if(nonortho_scheme != NONE)
+            nonOrthoCorrection(m,muc * gradl(cF));
     }
 
     /*end*/
@@ -2376,7 +3044,7 @@ MeshMatrix<type> ddt(MeshField<type,CELL>& cF,ScalarCellField* rho) {
     //others
     m.adg = Scalar(0);
     m.an[0] = Scalar(0);
-    m.an[1] = Scalar(0);
+    m.share();
     
     return m;
 }
@@ -2401,7 +3069,7 @@ MeshMatrix<type> ddt2(MeshField<type,CELL>& cF, ScalarCellField* rho) {
     //others
     m.adg = Scalar(0);
     m.an[0] = Scalar(0);
-    m.an[1] = Scalar(0);
+    m.share();
     
     return m;
 }   
@@ -2424,24 +3092,28 @@ void addTemporal(MeshMatrix<type>& M,Scalar cF_UR,ScalarCellField* rho = 0) {
             MeshField<type, CELL> k1 = M.Su - mul(M,  M.cF->tstore[0]);
             if(runge_kutta == 1) {
                 MeshField<type, CELL> val = k1  * (1 - implicit_factor);
-                M = M * (implicit_factor) + val;
+                M *= (implicit_factor);
+                M += val;
             } else {
                 ScalarCellField mdt = Controls::dt / (Mesh::cV);
                 if (runge_kutta == 2) {
                     MeshField<type, CELL> k2 = k1 - mul(M, k1 * mdt);
                     MeshField<type, CELL> val = ((k2 + k1) / 2) * (1 - implicit_factor);
-                    M = M * (implicit_factor) + val;
+                    M *= (implicit_factor);
+                    M += val;
                 } else if (runge_kutta == 3) {
                     MeshField<type, CELL> k2 = k1 - mul(M, k1 * mdt / 2);
                     MeshField<type, CELL> k3 = k1 - mul(M, (2 * k2 - k1) * mdt);
                     MeshField<type, CELL> val = ((k3 + 4 * k2 + k1) / 6) * (1 - implicit_factor);
-                    M = M * (implicit_factor) + val;
+                    M *= (implicit_factor);
+                    M += val;
                 } else if (runge_kutta == 4) {
                     MeshField<type, CELL> k2 = k1 - mul(M, k1 * mdt / 2);
                     MeshField<type, CELL> k3 = k1 - mul(M, k2 * mdt / 2);
                     MeshField<type, CELL> k4 = k1 - mul(M, k3 * mdt);
                     MeshField<type, CELL> val = ((k4 + 2 * k3 + 2 * k2 + k1) / 6) * (1 - implicit_factor);
-                    M = M * (implicit_factor) + val;
+                    M *= (implicit_factor);
+                    M += val;
                 }
             }
             if(equal(implicit_factor,0))
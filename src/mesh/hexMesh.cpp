@@ -33,10 +33,10 @@ void ADDV(int w,Scalar m,Edge* edges,Vector* vd) {
     }
 }
 /**
-Generate hexahedral mesh
+Spacing of divisions and shape of edges of a block
 */
-void hexMesh(Int* n,Scalar* s,Int* type,Vector* vp,Edge* edges,MeshObject& mo) {
-    Int i,j,k,m;
+static void initBlock(Int* n,Scalar* s,Int* type,Edge* edges,Scalar** sc) {
+    Int i,j;
 
     /*for wall division set twice 
     number of divisions requested*/
@@ -59,7 +59,6 @@ void hexMesh(Int* n,Scalar* s,Int* type,Vector* vp,Edge* edges,MeshObject& mo) {
     }
     
     /*calculate scale*/
-    Scalar* sc[12];
     for(i = 0;i < 12;i++) {
         Int nt = n[i / 4];
         sc[i] = new Scalar[nt + 1];
@@ -107,20 +106,16 @@ void hexMesh(Int* n,Scalar* s,Int* type,Vector* vp,Edge* edges,MeshObject& mo) {
             e.L = mag(mid - e.v[0]) / 2;
         }
     }
-    /*variables*/
+}
+/**
+Vertex (i,j,k) of a block
+*/
+static Vertex blockVertex(Int i,Int j,Int k,const Int* n,Scalar** sc,
+                          Vector* vp,Edge* edges) {
     Int nx = n[0] + 1 , ny = n[1] + 1 , nz = n[2] + 1;
-    const Int B1 = (nx - 0) * (ny - 1) * (nz - 1);
-    const Int B2 = (nx - 1) * (ny - 0) * (nz - 1);
-    const Int B3 = (nx - 1) * (ny - 1) * (nz - 0);
-    IntVector VI(nx * ny * nz,0);
-    IntVector FI(B1 + B2 + B3,0);
-
-    /*vertices*/
-    Vertex v,v1,v2,vd[12],vf[6];
+    Vertex v,vd[12],vf[6];
     Scalar rx,ry,rz;
 
-#define I0(i,j,k)  (i * ny * nz + j * nz + k)
-
 #define ADDF(w,rr,rs,i00,i01,i10,i11,ir0,ir1,i0s,i1s) { \
     vf[w] = Interpolate_face(                           \
             rr,rs,                                      \
@@ -128,41 +123,63 @@ void hexMesh(Int* n,Scalar* s,Int* type,Vector* vp,Edge* edges,MeshObject& mo) {
             vd[ir0],vd[ir1],vd[i0s],vd[i1s]);           \
 }
 
-#define ADDC() {                                        \
-    v = Interpolate_cell(                               \
-            rx,ry,rz,                                   \
-            vp[0],vp[4],vp[3],vp[7],                    \
-            vp[1],vp[5],vp[2],vp[6],                    \
-            vd[0],vd[3],vd[1],vd[2],                    \
-            vd[4],vd[7],vd[5],vd[6],                    \
-            vd[8],vd[11],vd[9],vd[10],                  \
-            vf[4],vf[5],vf[2],vf[3],vf[0],vf[1]);       \
+    ADDV(0,sc[0][i],edges,vd);
+    ADDV(1,sc[1][i],edges,vd);
+    ADDV(2,sc[2][i],edges,vd);
+    ADDV(3,sc[3][i],edges,vd);
+    ADDV(4,sc[4][j],edges,vd);
+    ADDV(5,sc[5][j],edges,vd);
+    ADDV(6,sc[6][j],edges,vd);
+    ADDV(7,sc[7][j],edges,vd);
+    ADDV(8,sc[8][k],edges,vd);
+    ADDV(9,sc[9][k],edges,vd);
+    ADDV(10,sc[10][k],edges,vd);
+    ADDV(11,sc[11][k],edges,vd);
+    rx = i / Scalar(nx - 1);
+    ry = j / Scalar(ny - 1);
+    rz = k / Scalar(nz - 1);
+    ADDF(0, rx,ry, 0,3,1,2, 0,1,4,5);
+    ADDF(1, rx,ry, 4,7,5,6, 3,2,7,6);
+    ADDF(2, rx,rz, 0,4,1,5, 0,3,8,9);
+    ADDF(3, rx,rz, 3,7,2,6, 1,2,11,10);
+    ADDF(4, ry,rz, 0,4,3,7, 4,7,8,11);
+    ADDF(5, ry,rz, 1,5,2,6, 5,6,9,10);
+    v = Interpolate_cell(
+            rx,ry,rz,
+            vp[0],vp[4],vp[3],vp[7],
+            vp[1],vp[5],vp[2],vp[6],
+            vd[0],vd[3],vd[1],vd[2],
+            vd[4],vd[7],vd[5],vd[6],
+            vd[8],vd[11],vd[9],vd[10],
+            vf[4],vf[5],vf[2],vf[3],vf[0],vf[1]);
+
+#undef ADDF
+    return v;
 }
+/**
+Generate hexahedral mesh
+*/
+void hexMesh(Int* n,Scalar* s,Int* type,Vector* vp,Edge* edges,MeshObject& mo) {
+    Int i,j,k,m;
+    Scalar* sc[12];
+    initBlock(n,s,type,edges,sc);
+
+    /*variables*/
+    Int nx = n[0] + 1 , ny = n[1] + 1 , nz = n[2] + 1;
+    const Int B1 = (nx - 0) * (ny - 1) * (nz - 1);
+    const Int B2 = (nx - 1) * (ny - 0) * (nz - 1);
+    const Int B3 = (nx - 1) * (ny - 1) * (nz - 0);
+    IntVector VI(nx * ny * nz,0);
+    IntVector FI(B1 + B2 + B3,0);
+
+    /*vertices*/
+    Vertex v;
+
+#define I0(i,j,k)  (i * ny * nz + j * nz + k)
 
 #define ADD() {                                     \
-    ADDV(0,sc[0][i],edges,vd);                      \
-    ADDV(1,sc[1][i],edges,vd);                      \
-    ADDV(2,sc[2][i],edges,vd);                      \
-    ADDV(3,sc[3][i],edges,vd);                      \
-    ADDV(4,sc[4][j],edges,vd);                      \
-    ADDV(5,sc[5][j],edges,vd);                      \
-    ADDV(6,sc[6][j],edges,vd);                      \
-    ADDV(7,sc[7][j],edges,vd);                      \
-    ADDV(8,sc[8][k],edges,vd);                      \
-    ADDV(9,sc[9][k],edges,vd);                      \
-    ADDV(10,sc[10][k],edges,vd);                    \
-    ADDV(11,sc[11][k],edges,vd);                    \
-    rx = i / Scalar(nx - 1);                        \
-    ry = j / Scalar(ny - 1);                        \
-    rz = k / Scalar(nz - 1);                        \
-    ADDF(0, rx,ry, 0,3,1,2, 0,1,4,5);               \
-    ADDF(1, rx,ry, 4,7,5,6, 3,2,7,6);               \
-    ADDF(2, rx,rz, 0,4,1,5, 0,3,8,9);               \
-    ADDF(3, rx,rz, 3,7,2,6, 1,2,11,10);             \
-    ADDF(4, ry,rz, 0,4,3,7, 4,7,8,11);              \
-    ADDF(5, ry,rz, 1,5,2,6, 5,6,9,10);              \
-    ADDC();                                         \
-};
+    v = blockVertex(i,j,k,n,sc,vp,edges);           \
+}
 
     /*interior*/
     for(j = 1;j < ny - 1;j++) {
@@ -206,12 +223,9 @@ void hexMesh(Int* n,Scalar* s,Int* type,Vector* vp,Edge* edges,MeshObject& mo) {
     }
     /*end*/
 #undef ADD
-#undef ADDF
-#undef ADDE
 
-    delete[] sc[0];
-    delete[] sc[1];
-    delete[] sc[2];
+    for(i = 0;i < 12;i++)
+        delete[] sc[i];
 
     /*faces*/
 #define I1(i,j,k)   (i * (ny - 1) * (nz - 1) + j * (nz - 1) + k)
@@ -348,23 +362,258 @@ NORMAL(1,2,6,5,mo.mPatches[5]);
         remove_duplicate(mo);
     /*end*/
 }
+/**
+Index of cell (i,j,k) of a block once the mesh is loaded, where cells
+next to the boundary are placed after the others
+*/
+static Int loadedCell(Int i,Int j,Int k,const Int* n) {
+    Int lex = i * n[1] * n[2] + j * n[2] + k;
+    if(n[0] < 3 || n[1] < 3 || n[2] < 3)
+        return lex;
+    Int m0 = n[0] - 2, m1 = n[1] - 2, m2 = n[2] - 2;
+    bool in0 = (i >= 1 && i <= m0);
+    bool in1 = (j >= 1 && j <= m1);
+    bool in2 = (k >= 1 && k <= m2);
+    if(in0 && in1 && in2)
+        return (i - 1) * m1 * m2 + (j - 1) * m2 + (k - 1);
+    /*interior cells before it*/
+    Int before = std::min(i ? i - 1 : 0,m0) * m1 * m2;
+    if(in0) {
+        before += std::min(j ? j - 1 : 0,m1) * m2;
+        if(in1)
+            before += std::min(k ? k - 1 : 0,m2);
+    }
+    return m0 * m1 * m2 + lex - before;
+}
+/**
+Index of face normal to direction d at lattice point x of a part
+with nv vertices along each direction
+*/
+static Int faceIndex(const Int* nv,Int d,const Int* x) {
+    Int c1 = nv[1] - (d != 1), c2 = nv[2] - (d != 2);
+    return (x[0] * c1 + x[1]) * c2 + x[2];
+}
+/**
+Add faces normal to direction d at lattice index q of a part
+*/
+static void addFaces(MeshObject& mo,IntVector& FI,const Int* nv,Int d,Int q) {
+    static const Int other[3][2] = {{1,2},{0,2},{0,1}};
+    const Int a = other[d][0], b = other[d][1];
+    Int x[3];
+    x[d] = q;
+    for(x[a] = 0;x[a] < nv[a] - 1;x[a]++) {
+        for(x[b] = 0;x[b] < nv[b] - 1;x[b]++) {
+            Int m = (x[0] * nv[1] + x[1]) * nv[2] + x[2];
+            Int sa = (a == 0) ? nv[1] * nv[2] : (a == 1) ? nv[2] : 1;
+            Int sb = (b == 0) ? nv[1] * nv[2] : (b == 1) ? nv[2] : 1;
+            Facet f(4);
+            f[0] = m;
+            f[1] = m + sa;
+            f[2] = m + sa + sb;
+            f[3] = m + sb;
+            mo.mFacets.push_back(f);
+            FI[faceIndex(nv,d,x)] = mo.mFacets.size() - 1;
+        }
+    }
+}
+/**
+Generate part ID of a hexahedral mesh split into np[0] x np[1] x np[2]
+parts. Faces shared with other parts form inter-processor boundaries
+and cLoc gets the index of each cell in the whole mesh. Blocks with 
+collapsed edges are not supported.
+*/
+bool hexMeshPart(Int* n,Scalar* s,Int* type,Vector* vp,Edge* edges,
+                 const Int* np,Int ID,MeshObject& mo,IntVector& cLoc) {
+    Int i,j,d;
+    for(i = 0;i < 8;i++) {
+        for(j = i + 1;j < 8;j++) {
+            if(equal(vp[i],vp[j]))
+                return false;
+        }
+    }
+    Scalar* sc[12];
+    initBlock(n,s,type,edges,sc);
+
+    /*range of cells*/
+    Int p[3],lo[3],hi[3],nv[3],x[3];
+    const Int stride[3] = {np[1] * np[2],np[2],1};
+    p[0] = ID / stride[0];
+    p[1] = (ID / stride[1]) % np[1];
+    p[2] = ID % np[2];
+    for(d = 0;d < 3;d++) {
+        lo[d] = (p[d] * n[d]) / np[d];
+        hi[d] = ((p[d] + 1) * n[d]) / np[d];
+        nv[d] = hi[d] - lo[d] + 1;
+    }
+
+    /*vertices*/
+    for(x[0] = 0;x[0] < nv[0];x[0]++) {
+        for(x[1] = 0;x[1] < nv[1];x[1]++) {
+            for(x[2] = 0;x[2] < nv[2];x[2]++) {
+                mo.mVertices.push_back(blockVertex(x[0] + lo[0],
+                    x[1] + lo[1],x[2] + lo[2],n,sc,vp,edges));
+            }
+        }
+    }
+    mo.mNV = mo.mVertices.size();
+    for(i = 0;i < 12;i++)
+        delete[] sc[i];
+
+    /*interior faces*/
+    IntVector FI[3];
+    for(d = 0;d < 3;d++) {
+        Int c[3] = {nv[0] - 1,nv[1] - 1,nv[2] - 1};
+        c[d]++;
+        FI[d].assign(c[0] * c[1] * c[2],0);
+    }
+    for(d = 3;d-- > 0;) {
+        for(i = 1;i < nv[d] - 1;i++)
+            addFaces(mo,FI[d],nv,d,i);
+    }
+    /*sides of the part in the order of block patches*/
+    bool onBlock[6];
+    for(i = 0;i < 6;i++) {
+        d = 2 - i / 2;
+        onBlock[i] = (i % 2) ? (hi[d] == n[d]) : (lo[d] == 0);
+    }
+    /*faces shared with neighboring parts*/
+    for(i = 0;i < 6;i++) {
+        if(onBlock[i]) continue;
+        d = 2 - i / 2;
+        Int from = mo.mFacets.size();
+        addFaces(mo,FI[d],nv,d,(i % 2) ? nv[d] - 1 : 0);
+        
+        std::stringstream name;
+        name << std::hex << "interMesh_" << ID << "_" 
+             << ((i % 2) ? ID + stride[d] : ID - stride[d]);
+        IntVector& b = mo.mBoundaries[name.str()];
+        for(j = from;j < mo.mFacets.size();j++)
+            b.push_back(j);
+    }
+    mo.mNF = mo.mFacets.size();
+    /*faces on boundaries of the block*/
+#define NORMAL(i,j,k,l,p) {                     \
+    p.N = ((vp[j] - vp[i]) ^ (vp[k] - vp[i]));  \
+    p.N /= mag(p.N);                            \
+    p.C = (vp[i] + vp[j] + vp[k] + vp[l]) / 4;  \
+}
+    static const Int corner[6][4] = {
+        {0,1,2,3}, {4,5,6,7}, {0,1,5,4},
+        {3,2,6,7}, {0,3,7,4}, {1,2,6,5}
+    };
+    for(i = 0;i < 6;i++) {
+        if(!onBlock[i]) continue;
+        d = 2 - i / 2;
+        Patch pt;
+        pt.from = mo.mFacets.size();
+        addFaces(mo,FI[d],nv,d,(i % 2) ? nv[d] - 1 : 0);
+        pt.to = mo.mFacets.size();
+        const Int* q = corner[i];
+        NORMAL(q[0],q[1],q[2],q[3],pt);
+        mo.mPatches.push_back(pt);
+    }
+#undef NORMAL
+
+    /*cells: those next to the sides of the part go last,
+      both in the order of the whole mesh*/
+    typedef std::pair<Int,Cell> IndexedCell;
+    std::vector<IndexedCell> sideCells;
+    for(x[0] = 0;x[0] < nv[0] - 1;x[0]++) {
+        for(x[1] = 0;x[1] < nv[1] - 1;x[1]++) {
+            for(x[2] = 0;x[2] < nv[2] - 1;x[2]++) {
+                Cell c;
+                for(d = 3;d-- > 0;) {
+                    c.push_back(FI[d][faceIndex(nv,d,x)]);
+                    x[d]++;
+                    c.push_back(FI[d][faceIndex(nv,d,x)]);
+                    x[d]--;
+                }
+                Int g = loadedCell(x[0] + lo[0],x[1] + lo[1],x[2] + lo[2],n);
+                bool side = false;
+                for(d = 0;d < 3;d++) {
+                    if(x[d] == 0 || x[d] == nv[d] - 2)
+                        side = true;
+                }
+                if(side)
+                    sideCells.push_back(IndexedCell(g,c));
+                else {
+                    mo.mCells.push_back(c);
+                    cLoc.push_back(g);
+                }
+            }
+        }
+    }
+    std::sort(sideCells.begin(),sideCells.end());
+    forEach(sideCells,i) {
+        mo.mCells.push_back(sideCells[i].second);
+        cLoc.push_back(sideCells[i].first);
+    }
+    mo.mBCS = mo.mCells.size();
+    return true;
+}
 
+/**
+Spatial hash cell of a coordinate
+*/
+static long long hashIndex(Scalar x) {
+    return (long long)floor(x / (4 * Constants::EqualEpsilon));
+}
+/**
+Add a point to the hash
+*/
+void PointHash::insert(const Vector& v,Int id) {
+    Key k;
+    k.i = hashIndex(v[0]);
+    k.j = hashIndex(v[1]);
+    k.k = hashIndex(v[2]);
+    cells[k].push_back(id);
+}
+/**
+Ids of points in cells that may hold points equal to v
+*/
+void PointHash::find(const Vector& v,IntVector& ids) const {
+    const Scalar e = Constants::EqualEpsilon;
+    Key k,lo,hi;
+    lo.i = hashIndex(v[0] - e); hi.i = hashIndex(v[0] + e);
+    lo.j = hashIndex(v[1] - e); hi.j = hashIndex(v[1] + e);
+    lo.k = hashIndex(v[2] - e); hi.k = hashIndex(v[2] + e);
+    ids.clear();
+    for(k.i = lo.i;k.i <= hi.i;k.i++) {
+        for(k.j = lo.j;k.j <= hi.j;k.j++) {
+            for(k.k = lo.k;k.k <= hi.k;k.k++) {
+                std::map<Key,IntVector>::const_iterator it = cells.find(k);
+                if(it != cells.end())
+                    ids.insert(ids.end(),it->second.begin(),it->second.end());
+            }
+        }
+    }
+}
 /**
 Remove duplicate vertices,faces and cells
 */
 void remove_duplicate(Mesh::MeshObject& mo) {
-    Int i,j,sz,corr;
+    Int i,sz,corr,nv = 0,nf = 0;
     int count;
-    /*vertices*/
+    /*vertices: each is replaced by the last vertex equal to it*/
     sz = mo.mVertices.size();
     corr = 0;
     std::vector<int> dup(sz,0);
-    for(i = 0;i < sz;i++) {
-        for(j = sz - 1;j >= i + 1;j--) {
-            if(equal(mo.mVertices[i],mo.mVertices[j])) {
-                dup[i] = -int(j);
+    {
+        PointHash hash;
+        IntVector ids;
+        for(i = 0;i < sz;i++)
+            hash.insert(mo.mVertices[i],i);
+        for(i = 0;i < sz;i++) {
+            hash.find(mo.mVertices[i],ids);
+            Int last = i;
+            forEach(ids,m) {
+                if(ids[m] > last && equal(mo.mVertices[i],mo.mVertices[ids[m]]))
+                    last = ids[m];
+            }
+            if(last != i) {
+                dup[i] = -int(last);
                 if(i < mo.mNV) corr++;
-                break;
+                nv++;
             }
         }
     }
@@ -409,6 +658,7 @@ void remove_duplicate(Mesh::MeshObject& mo) {
         if(f.size() < 3) {
             dup[i] = -1;
             if(i < mo.mNF) corr++;
+            nf++;
         } else {
             dup[i] = count;
             count++;
@@ -441,6 +691,8 @@ void remove_duplicate(Mesh::MeshObject& mo) {
                 c[j] = dup[c[j]];
         }
     }
+    std::cerr << "Removed " << nv << " duplicate vertices and "
+              << nf << " degenerate faces" << std::endl;
 }
 
 #define MAXNUM 1073741824
@@ -460,17 +712,21 @@ void merge(MeshObject& m1,MergeObject& b,MeshObject& m2) {
         m1.mVertices.insert(m1.mVertices.end(),m2.mVertices.begin(),m2.mVertices.begin() + s1);
 
         IntVector locv(s2 - s1,MAXNUM);
+        IntVector ids;
         for(Int i = s1;i < s2;i++) {
-            found = 0;
-            for(Int j = 0;j < s3;j++) {
-                if(equal(m2.mVertices[i],b.vb[j])) {
-                    locv[i - s1] += j;
-                    found = 1;
-                    break;
-                }
+            /*first of the previous boundary vertices equal to it*/
+            found = s3;
+            b.vhash.find(m2.mVertices[i],ids);
+            forEach(ids,k) {
+                if(ids[k] < found && equal(m2.mVertices[i],b.vb[ids[k]]))
+                    found = ids[k];
             }
-            if(!found) {
+            if(found < s3) {
+                locv[i - s1] += found;
+                b.nvm++;
+            } else {
                 b.vb.push_back(m2.mVertices[i]);
+                b.vhash.insert(m2.mVertices[i],b.vb.size() - 1);
                 locv[i - s1] += b.vb.size() - 1;
             }
         }
@@ -493,21 +749,43 @@ void merge(MeshObject& m1,MergeObject& b,MeshObject& m2) {
         s3 = b.fb.size();
         m1.mFacets.insert(m1.mFacets.end(),m2.mFacets.begin(),m2.mFacets.begin() + s1);
         
+        //boundary faces of m2 keyed by their sorted vertices
+        typedef std::multimap<IntVector,Int> FaceMap;
+        FaceMap fmap;
+        std::vector<bool> near(b.vb.size(),false);
+        IntVector key;
+        for(Int i = s1;i < s2;i++) {
+            const Facet& f = m2.mFacets[i];
+            key.assign(f.begin(),f.end());
+            std::sort(key.begin(),key.end());
+            fmap.insert(FaceMap::value_type(key,i));
+            forEach(f,j) {
+                if(f[j] >= MAXNUM)
+                    near[f[j] - MAXNUM] = true;
+            }
+        }
+        
         //insert faces
         IntVector index0(s3,0),index1(s2 - s1,0);
         Int count = 0;
         b.fb.reserve(s3 + s2 - s1);
         for(Int j = 0;j < s3;j++) {
             found = 0;
-            for(Int i = s1;i < s2;i++) {
-                if(!index1[i - s1] && equal(m2.mFacets[i],b.fb[j])) {
+            const Int v0 = b.fb[j][0];
+            if(!fmap.empty() && (v0 < MAXNUM || near[v0 - MAXNUM])) {
+                key.assign(b.fb[j].begin(),b.fb[j].end());
+                std::sort(key.begin(),key.end());
+                FaceMap::iterator it = fmap.lower_bound(key);
+                if(it != fmap.end() && it->first == key) {
+                    Int i = it->second;
+                    fmap.erase(it);
 
                     m1.mFacets.push_back(b.fb[j]);
                     index0[j]      = m1.mFacets.size() - 1;
                     index1[i - s1] = m1.mFacets.size() - 1;
 
                     found = 1;
-                    break;
+                    b.nfm++;
                 }
             }
             if(!found) {
@@ -591,6 +869,8 @@ void merge(MeshObject& m1,MergeObject& b,MeshObject& m2) {
 Merge boundary and internals
 */
 void merge(Mesh::MeshObject& m,MergeObject& b) {
+    std::cerr << "Merged blocks sharing " << b.nvm << " vertices and "
+              << b.nfm << " faces" << std::endl;
     m.mNV = m.mVertices.size();
     m.mNF = m.mFacets.size();
     m.mBCS = m.mCells.size();
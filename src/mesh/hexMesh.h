@@ -31,12 +31,36 @@ struct Edge {
     }
 };
 
+/** Spatial hash of points. Cells are larger than the tolerance of
+    equal(), so points equal to a given one lie in at most 8 cells. */
+struct PointHash {
+    struct Key {
+        long long i,j,k;
+        bool operator < (const Key& p) const {
+            if(i != p.i) return i < p.i;
+            if(j != p.j) return j < p.j;
+            return k < p.k;
+        }
+    };
+    std::map<Key,IntVector> cells;
+    
+    void insert(const Vector&,Int);
+    void find(const Vector&,IntVector&) const;
+};
+
 struct MergeObject {
-    Vertices vb;
-    Facets   fb;
+    Vertices  vb;
+    Facets    fb;
+    PointHash vhash;    /**< Spatial hash of vb */
+    Int       nvm;      /**< Number of matched vertices */
+    Int       nfm;      /**< Number of matched faces */
+    MergeObject() : nvm(0), nfm(0) {
+    }
 };
 
 void hexMesh(Int* n,Scalar* s,Int* type,Vector* vp,Edge* edges,Mesh::MeshObject& mo);
+bool hexMeshPart(Int* n,Scalar* s,Int* type,Vector* vp,Edge* edges,
+                 const Int* np,Int ID,Mesh::MeshObject& mo,IntVector& cLoc);
 void merge(Mesh::MeshObject&,MergeObject&,Mesh::MeshObject&);
 void remove_duplicate(Mesh::MeshObject&);
 void merge(Mesh::MeshObject&,MergeObject&);
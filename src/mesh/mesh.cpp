@@ -18,7 +18,8 @@ namespace Mesh {
     IntVector&        gFNC = gMesh.mFNC;
     Int&              gBCS = gMesh.mBCS;
     Int&              gBCSI = gMesh.mBCSI;
-    Cells&            gFaceID = gMesh.mFaceID;
+    Int&              gHCS = gMesh.mHCS;
+    Compressed&       gFaceID = gMesh.mFaceID;
     InterBoundVector& gInterMesh = gMesh.mInterMesh;
     NodeVector&       gAmrTree = gMesh.mAmrTree;
     VectorVector&     gFC = gMesh.mFC;
@@ -43,6 +44,15 @@ void Mesh::MeshObject::clear() {
     mAmrTree.clear();
 }
 /**
+Release geometry once it is held by the mesh fields
+*/
+void Mesh::MeshObject::clearGeometry() {
+    VectorVector().swap(mFC);
+    VectorVector().swap(mCC);
+    VectorVector().swap(mFN);
+    ScalarVector().swap(mCV);
+}
+/**
 Read mesh at given time step
 */
 bool Mesh::MeshObject::readMesh(Int step,bool first) {
@@ -71,23 +81,47 @@ bool Mesh::MeshObject::readMesh(Int step,bool first) {
         is >> str;
         is >> index;
 
+        /*halo cells and cells to send for ghost depth 2*/
+        if(str.find("interHalo") != string::npos ||
+           str.find("interSend") != string::npos) {
+            unsigned from,to;
+            bool halo = (str.find("interHalo") != string::npos);
+            sscanf(str.c_str(), halo ? "interHalo_%x_%x" : "interSend_%x_%x", 
+                &from,&to);
+            forEach(mInterMesh,i) {
+                interBoundary& b = mInterMesh[i];
+                if(b.to == to) {
+                    if(halo) b.hc = index;
+                    else b.sc = index;
+                    break;
+                }
+            }
+            continue;
+        }
+
         IntVector& gB = mBoundaries[str];
         gB.insert(gB.begin(),index.begin(),index.end());
 
         /*internal mesh boundaries*/
         if(str.find("interMesh") != string::npos) {
             interBoundary b;
-            sscanf(str.c_str(), "interMesh_%x_%x", &b.from,&b.to);
+            unsigned from,to;
+            sscanf(str.c_str(), "interMesh_%x_%x", &from,&to);
+            b.from = from;
+            b.to   = to;
             b.f    = &mBoundaries[str];
             mInterMesh.push_back(b);
         }
     }
     /*start of buffer*/ 
     Int buffer_index = 0;
+    Int send_index = 0;
     forEach(mInterMesh,i) {
         interBoundary& b = mInterMesh[i];
         b.buffer_index = buffer_index;
-        buffer_index += b.f->size();
+        b.send_index = send_index;
+        buffer_index += b.hc.size() + b.f->size();
+        send_index += (b.sc.size() ? b.sc.size() : b.f->size());
     }
     is >> dec;
     return true;
@@ -107,13 +141,11 @@ void Mesh::MeshObject::writeMesh(ostream& os) {
     os << dec;
 }
 /**
-Add boundary cells around mesh
+Find owner and neighbor cells of faces
 */
-void Mesh::MeshObject::addBoundaryCells() {
+void Mesh::MeshObject::calcFaceCells() {
     using namespace Constants;
-    
-    /*neighbor and owner cells of face*/
-    mBCS = mCells.size();
+
     mFOC.assign(mFacets.size(),MAX_INT);
     mFNC.assign(mFacets.size(),MAX_INT);
     forEach(mCells,i) {
@@ -126,6 +158,62 @@ void Mesh::MeshObject::addBoundaryCells() {
                 mFNC[fi] = i;
         }
     }
+}
+/**
+Compress rows of indices
+*/
+void Mesh::Compressed::compress(const std::vector<IntVector>& rows) {
+    start.resize(rows.size() + 1);
+    start[0] = 0;
+    forEach(rows,i)
+        start[i + 1] = start[i] + rows[i].size();
+    index.resize(start.back());
+    forEach(rows,i)
+        std::copy(rows[i].begin(),rows[i].end(),index.begin() + start[i]);
+}
+/**
+Expand to rows of indices
+*/
+void Mesh::Compressed::expand(std::vector<IntVector>& rows) const {
+    rows.resize(size());
+    forEach(rows,i)
+        rows[i].assign(index.begin() + start[i],index.begin() + start[i + 1]);
+}
+/**
+Erase rows given in increasing order, repeated rows are erased once
+*/
+void Mesh::Compressed::erase(const IntVector& rows) {
+    if(rows.empty())
+        return;
+    Int n = 0, k = 0, r = 0;
+    for(Int i = 0;i < size();i++) {
+        if(r < rows.size() && rows[r] == i) {
+            while(r < rows.size() && rows[r] == i)
+                r++;
+            continue;
+        }
+        for(Int j = start[i];j < start[i + 1];j++)
+            index[k++] = index[j];
+        start[++n] = k;
+    }
+    start.resize(n + 1);
+    index.resize(k);
+}
+/**
+Add boundary cells around mesh
+*/
+void Mesh::MeshObject::addBoundaryCells() {
+    using namespace Constants;
+    
+    /*halo cells are stored after internal cells*/
+    mHCS = mCells.size();
+    mBCS = mHCS;
+    forEach(mInterMesh,i)
+        mBCS -= mInterMesh[i].hc.size();
+    
+    /*neighbor and owner cells of face*/
+    calcFaceCells();
+    
     /*Flag boundary faces not in mBoundaries for auto deletion*/
     {
         IntVector faceInB;
@@ -144,34 +232,38 @@ void Mesh::MeshObject::addBoundaryCells() {
             }
         }
     }
-    /*reorder cells*/
+    /*reorder cells: those next to boundary or halo cells go last*/
     {   
-        Cells bcs;
-        IntVector allbs;
+        BoolVector bdry(mBCS,false);
         Int count = 0;
-        Int bdry_size = 0;
-        
-        forEachIt(Boundaries,mBoundaries,it)
-            bdry_size += it->second.size();
-        bcs.resize(bdry_size);
-        allbs.resize(bdry_size);
-        forEach(mCells,i) {
+        for(Int i = 0;i < mBCS;i++) {
             Cell& c = mCells[i];
             forEach(c,j) {
-                Int fi = c[j];
-                if(mFNC[fi] == MAX_INT) {
-                    allbs[count] = i;
-                    bcs[count] = c;
+                Int fn = mFNC[c[j]];
+                if(fn == MAX_INT || fn >= mBCS) {
+                    bdry[i] = true;
                     count++;
                     break;
                 }
             }
         }
         mBCSI = mBCS - count;
-        allbs.resize(count);
-        bcs.resize(count);
-        erase_indices(mCells,allbs);
-        mCells.insert(mCells.end(),bcs.begin(),bcs.end());
+        if(count && mBCSI) {
+            Cells cells(mCells.begin(),mCells.begin() + mBCS);
+            IntVector cellMap(mBCS);
+            Int ni = 0, nb = mBCSI;
+            for(Int i = 0;i < mBCS;i++) {
+                Int k = bdry[i] ? nb++ : ni++;
+                cellMap[i] = k;
+                mCells[k] = cells[i];
+            }
+            forEach(mInterMesh,i) {
+                IntVector& sc = mInterMesh[i].sc;
+                forEach(sc,j)
+                    sc[j] = cellMap[sc[j]];
+            }
+            calcFaceCells();
+        }
     }
     /*add boundary cells*/
     forEachIt(Boundaries,mBoundaries,it) {
@@ -188,6 +280,58 @@ void Mesh::MeshObject::addBoundaryCells() {
     }
 }
 /**
+Renumber internal cells in the given order (new to old). Halo and
+boundary cells keep their place. Faces are then ordered by their owner
+and neighbor cells.
+*/
+void Mesh::MeshObject::renumber(const IntVector& order) {
+    /*cells*/
+    IntVector cellMap(mCells.size());
+    forEach(cellMap,i)
+        cellMap[i] = i;
+    {
+        Cells cells(mCells.begin(),mCells.begin() + order.size());
+        forEach(order,i) {
+            mCells[i] = cells[order[i]];
+            cellMap[order[i]] = i;
+        }
+    }
+    forEach(mInterMesh,i) {
+        IntVector& sc = mInterMesh[i].sc;
+        forEach(sc,j)
+            sc[j] = cellMap[sc[j]];
+    }
+    calcFaceCells();
+    /*faces*/
+    typedef std::pair<std::pair<Int,Int>,Int> FaceKey;
+    std::vector<FaceKey> keys(mFacets.size());
+    forEach(mFacets,i)
+        keys[i] = FaceKey(std::make_pair(mFOC[i],mFNC[i]),i);
+    std::sort(keys.begin(),keys.end());
+    IntVector faceMap(mFacets.size());
+    {
+        Facets facets;
+        facets.swap(mFacets);
+        mFacets.resize(facets.size());
+        forEach(keys,i) {
+            Int fi = keys[i].second;
+            mFacets[i].swap(facets[fi]);
+            faceMap[fi] = i;
+        }
+    }
+    forEach(mCells,i) {
+        Cell& c = mCells[i];
+        forEach(c,j)
+            c[j] = faceMap[c[j]];
+    }
+    forEachIt(Boundaries,mBoundaries,it) {
+        IntVector& mB = it->second;
+        forEach(mB,j)
+            mB[j] = faceMap[mB[j]];
+    }
+    calcFaceCells();
+}
+/**
 Calculate geometric information
 */
 void Mesh::MeshObject::calcGeometry() {
@@ -243,7 +387,7 @@ void Mesh::MeshObject::calcGeometry() {
         mFN[i] = N / Scalar(2);
     }
     /* cell volumes */
-    for(i = 0;i < mBCS;i++) {
+    for(i = 0;i < mHCS;i++) {
         Cell& c = mCells[i];
         Scalar V(0);
         Vector C(0);
@@ -257,18 +401,16 @@ void Mesh::MeshObject::calcGeometry() {
         mCV[i] = V / Scalar(3);
     }
     /*boundary cell centre and volume*/
-    forEachS(mCells,i,mBCS) {
+    forEachS(mCells,i,mHCS) {
         Int fi = mCells[i][0];
         mCV[i] = mCV[mFOC[fi]];
         mCC[i] = mFC[fi];
     }
     /*facet ids*/
-    mFaceID.clear();
+    mFaceID.compress(mCells);
     forEach(mCells,i) {
-        IntVector b;
-        forEach(mCells[i],j)
-            b.push_back(j);
-        mFaceID.push_back(b);
+        for(Int j = mFaceID.start[i];j < mFaceID.start[i + 1];j++)
+            mFaceID.index[j] = j - mFaceID.start[i];
     }
 }
 /** 
@@ -279,32 +421,30 @@ void Mesh::MeshObject::removeBoundary(const IntVector& fs) {
     IntVector Idf(mFacets.size(),0);
     IntVector Idc(mCells.size(),0);
     
-    /*erase facet reference*/
-    forEach(fs,i) {
-        Int f = fs[i];
-        Cell& co = mCells[mFOC[f]];
-        Cell& coid = mFaceID[mFOC[f]];
-        forEach(co,j) {
-            if(co[j] == f) {
-                co.erase(co.begin() + j); 
-                coid.erase(coid.begin() + j);
-                break; 
-            }
-        }
-        Cell& cn = mCells[mFNC[f]];
-        Cell& cnid = mFaceID[mFNC[f]];
-        forEach(cn,j) {
-            if(cn[j] == f) { 
-                cn.erase(cn.begin() + j); 
-                cnid.erase(cnid.begin() + j); 
-                break; 
+    /*erase facet reference and its face id in one pass*/
+    forEach(fs,i)
+        Idf[fs[i]] = Constants::MAX_INT;
+    {
+        Compressed faceID;
+        faceID.index.reserve(mFaceID.index.size());
+        faceID.start.reserve(mFaceID.start.size());
+        forEach(mCells,i) {
+            Cell& c = mCells[i];
+            Int k = 0;
+            forEach(c,j) {
+                if(Idf[c[j]] != Constants::MAX_INT) {
+                    faceID.index.push_back(mFaceID.index[mFaceID.start[i] + j]);
+                    c[k++] = c[j];
+                }
             }
+            c.resize(k);
+            faceID.start.push_back(faceID.index.size());
         }
+        mFaceID.start.swap(faceID.start);
+        mFaceID.index.swap(faceID.index);
     }
     
     /*updated facet id*/
-    forEach(fs,i)
-        Idf[fs[i]] = Constants::MAX_INT;
     count = 0;
     forEach(mFacets,i) {
         if(Idf[i] != Constants::MAX_INT) 
@@ -339,7 +479,7 @@ void Mesh::MeshObject::removeBoundary(const IntVector& fs) {
             czeroIndices.push_back(i);
     }
     erase_indices(mCells,czeroIndices);
-    erase_indices(mFaceID,czeroIndices);
+    mFaceID.erase(czeroIndices);
     erase_indices(mCC,czeroIndices);
     erase_indices(mCV,czeroIndices);
     
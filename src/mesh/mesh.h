@@ -29,7 +29,54 @@ namespace Mesh {
         IntVector* f;
         Int from;
         Int to;
-        Int buffer_index;
+        Int buffer_index;   /**< Start of recieve buffer */
+        Int send_index;     /**< Start of send buffer */
+        IntVector hc;       /**< Halo cells filled from the neighbor */
+        IntVector sc;       /**< Cells sent to the neighbor (ghost depth 2) */
+    };
+    
+    /** Connectivity compressed into row offsets and indices */
+    struct Compressed {
+        IntVector start;    /**< Offset of each row and the end of the last */
+        IntVector index;    /**< Indices of all rows */
+        
+        /** A row of the connectivity */
+        struct Row {
+            const Int* p;
+            Int n;
+            Int size() const {
+                return n;
+            }
+            Int operator [] (Int j) const {
+                return p[j];
+            }
+        };
+        
+        Compressed() : start(1,0) {
+        }
+        Int size() const {
+            return start.size() - 1;
+        }
+        Int size(Int i) const {
+            return start[i + 1] - start[i];
+        }
+        Row operator [] (Int i) const {
+            Row r;
+            r.p = index.empty() ? 0 : &index[0] + start[i];
+            r.n = size(i);
+            return r;
+        }
+        void clear() {
+            start.assign(1,0);
+            index.clear();
+        }
+        void push_back(const IntVector& r) {
+            index.insert(index.end(),r.begin(),r.end());
+            start.push_back(index.size());
+        }
+        void compress(const std::vector<IntVector>&);
+        void expand(std::vector<IntVector>&) const;
+        void erase(const IntVector&);
     };
     
     /** Boundary patch */
@@ -84,11 +131,12 @@ namespace Mesh {
         Int      mNF;   /**< Number of faces */
         Int      mBCS;  /**< Number of internal cells */
         Int      mBCSI; /**< Number of internal cells one layer away from boundary */
+        Int      mHCS;  /**< Number of internal and halo cells */
 
         PatchVector      mPatches;      /**< List of patches */
         InterBoundVector mInterMesh;    /**< List of inter-processor boundaries */
         
-        Cells    mFaceID;   /**< Original face orientation*/
+        Compressed mFaceID; /**< Original face orientation*/
 
         VectorVector mFC;   /**< Facet centers */
         VectorVector mCC;   /**< Cell centers */
@@ -100,13 +148,16 @@ namespace Mesh {
         
         /*functions*/
         void clear();
+        void clearGeometry();
         void writeMesh(std::ostream&);
         bool readMesh(Int = 0,bool = true);
         void writeMshMesh(std::ostream&);
         void readMshMesh(std::istream&);
+        void calcFaceCells();
         void addBoundaryCells();
         void calcGeometry();
         void removeBoundary(const IntVector&);
+        void renumber(const IntVector&);
         Int  removeUnusedVertices(Int = 0);
         void breakEdges(Int);
         
@@ -140,7 +191,8 @@ namespace Mesh {
     extern  IntVector&        gFNC;
     extern  Int&              gBCS;
     extern  Int&              gBCSI;
-    extern  Cells&            gFaceID;
+    extern  Int&              gHCS;
+    extern  Compressed&       gFaceID;
     extern  InterBoundVector& gInterMesh;
     extern  NodeVector&       gAmrTree;
     extern  VectorVector&     gFC;
@@ -1,4 +1,6 @@
 #include "hexMesh.h"
+#include "mp.h"
+#include "system.h"
 
 using namespace std;
 
@@ -10,6 +12,120 @@ struct Bdry {
     IntVector index;
 };
 
+/**
+Block of a multi-block mesh
+*/
+struct Block {
+    IntVector n;
+    std::vector<Scalar> s;
+    std::vector<Int> t;
+    Vertices v;
+    std::vector<Edge> edges;
+};
+
+/**
+Add named boundaries and the default boundary to a mesh
+*/
+static void addBoundaries(Mesh::MeshObject& m,const Vertices& corners,
+                          vector<Bdry>& patches,const string& default_name) {
+    using namespace Mesh;
+    forEach(patches,i) {
+        IntVector list;
+        IntVector& b = patches[i].index;
+        Vector N = (corners[b[1]] - corners[b[0]]) ^ (corners[b[2]] - corners[b[0]]);
+        N /= mag(N);
+        
+        forEach(m.mPatches,j) {
+            Patch& p = m.mPatches[j];
+            Vector H = (p.C - corners[b[0]]);
+            Scalar d1 = mag(N ^ p.N);
+            Scalar d2 = sqrt(mag(N & H));
+            // if(Mesh::pointInPolygon(corners,b,p.C))
+            if(d1 <= 10e-4 && d2 <= 10e-4) {
+                for(Int k = p.from;k < p.to;k++)
+                    list.push_back(k);
+            }
+        }
+        
+        if(!list.empty()) {
+            IntVector& gB = m.mBoundaries[patches[i].name.c_str()];
+            IntVector::iterator it = find(gB.begin(),gB.end(),list[0]);
+            if(it == gB.end()) {
+                forEach(list,j)
+                    gB.push_back(list[j]);
+            }
+        }
+    }
+    /*default specified*/
+    if(!default_name.empty()) {
+        IntVector faceInB;
+        faceInB.assign(m.mFacets.size(),0);
+        forEachIt(Boundaries,m.mBoundaries,it) {
+            IntVector& gB = it->second; 
+            forEach(gB,j)
+                faceInB[gB[j]] = 1;
+        }
+    
+        IntVector& gB = m.mBoundaries[default_name.c_str()];
+        forEachS(m.mFacets,i,m.mNF) {
+            if(!faceInB[i])
+                gB.push_back(i);
+        }
+    }
+}
+
+/**
+Generate parts of a single block mesh directly in the directories
+read by the solver. Parts are shared among the processes.
+*/
+static int writeParts(int argc,char* argv[],vector<Block>& blocks,
+                      const Vertices& corners,vector<Bdry>& patches,
+                      const string& default_name,const Int* np,
+                      const string& name) {
+    using namespace Mesh;
+    if(blocks.size() != 1) {
+        std::cerr << "Partitioned generation needs a single block" << std::endl;
+        return 1;
+    }
+    for(Int d = 0;d < 3;d++) {
+        if(np[d] < 1 || np[d] > blocks[0].n[d]) {
+            std::cerr << "Number of parts must be between 1 and the number "
+                      << "of divisions" << std::endl;
+            return 1;
+        }
+    }
+    MP mp(argc,argv);
+    Int total = np[0] * np[1] * np[2];
+    for(Int ID = MP::host_id;ID < total;ID += MP::n_hosts) {
+        /*generate*/
+        Block b = blocks[0];
+        MeshObject mo;
+        IntVector cLoc;
+        if(!hexMeshPart(&b.n[0],&b.s[0],&b.t[0],&b.v[0],&b.edges[0],
+                        np,ID,mo,cLoc)) {
+            std::cerr << "Partitioned generation does not support "
+                      << "collapsed edges" << std::endl;
+            return 1;
+        }
+        addBoundaries(mo,corners,patches,default_name);
+        printf("Part %d: %d vertices\t%d facets\t%d cells\n",int(ID),
+            int(mo.mVertices.size()),int(mo.mFacets.size()),int(mo.mCells.size()));
+
+        /*write mesh and index*/
+        stringstream path;
+        path << name << ID;
+        System::mkdir(path.str());
+        stringstream mpath,ipath;
+        mpath << path.str() << "/" << name << "_0";
+        ipath << path.str() << "/index_0";
+        ofstream of(mpath.str().c_str());
+        mo.writeMesh(of);
+        ofstream of2(ipath.str().c_str());
+        of2 << cLoc << endl;
+    }
+    return 0;
+}
+
 /**
 Mesh generator application
 */
@@ -18,6 +134,7 @@ int main(int argc,char* argv[]) {
     using namespace Util;
     Vertices corners;
     vector<Bdry> patches;
+    vector<Block> blocks;
     MergeObject bMerge;
     string str;
     string default_name;
@@ -25,6 +142,9 @@ int main(int argc,char* argv[]) {
     char* e_file_name = 0;
     bool Import = false;
     bool Export = false;
+    bool Partition = false;
+    Int np[3] = {1,1,1};
+    string mesh_name = "grid";
     char c;
 
     /*command line arguments*/
@@ -37,12 +157,28 @@ int main(int argc,char* argv[]) {
             i++;
             Export = true;
             e_file_name = argv[i];
+        } else if(!strcmp(argv[i],"-n")) {
+            Partition = true;
+            Int j = 0;
+            for(;i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9';j++) {
+                i++;
+                if(j < 3) np[j] = atoi(argv[i]);
+            }
+            if(j != 3) {
+                std::cerr << "Option -n needs exactly three part counts <x> <y> <z>" << std::endl;
+                return 1;
+            }
+        } else if(!strcmp(argv[i],"-name")) {
+            i++;
+            mesh_name = argv[i];
         } else if(!strcmp(argv[i],"-h")) {
             std::cout << "Usage:\n"
                       << "  ./mesh <inputfile> <Options>\n"
                       << "Options:\n"
                       << "  -i     --  Import from Fluent .msh file\n"
                       << "  -o     --  Export to Fluent .msh file format\n"
+                      << "  -n     --  Generate <x> <y> <z> parts of a single block\n"
+                      << "  -name  --  Name of the parts (default grid)\n"
                       << "  -h     --  Display this message\n\n";
             return 0;
         } 
@@ -199,9 +335,19 @@ int main(int argc,char* argv[]) {
             }
 
             //generate mesh
-            MeshObject mo;
-            hexMesh(&n[0],&s[0],&t[0],&v[0],&edges[0],mo);
-            merge(gMesh,bMerge,mo);
+            if(Partition) {
+                Block b;
+                b.n = n;
+                b.s = s;
+                b.t = t;
+                b.v = v;
+                b.edges = edges;
+                blocks.push_back(b);
+            } else {
+                MeshObject mo;
+                hexMesh(&n[0],&s[0],&t[0],&v[0],&edges[0],mo);
+                merge(gMesh,bMerge,mo);
+            }
         } else {
             /*read boundaries*/
             Bdry b;
@@ -216,53 +362,17 @@ int main(int argc,char* argv[]) {
             }
         }
     }
+    /*parts of the mesh*/
+    if(Partition)
+        return writeParts(argc,argv,blocks,corners,patches,
+                          default_name,np,mesh_name);
+    
     /*merge boundary & internals*/
     merge(gMesh,bMerge);
     
     /*boundaries*/
-    forEach(patches,i) {
-        IntVector list;
-        IntVector& b = patches[i].index;
-        Vector N = (corners[b[1]] - corners[b[0]]) ^ (corners[b[2]] - corners[b[0]]);
-        N /= mag(N);
-        
-        forEach(gMesh.mPatches,j) {
-            Patch& p = gMesh.mPatches[j];
-            Vector H = (p.C - corners[b[0]]);
-            Scalar d1 = mag(N ^ p.N);
-            Scalar d2 = sqrt(mag(N & H));
-            // if(Mesh::pointInPolygon(corners,b,p.C))
-            if(d1 <= 10e-4 && d2 <= 10e-4) {
-                for(Int k = p.from;k < p.to;k++)
-                    list.push_back(k);
-            }
-        }
-        
-        if(!list.empty()) {
-            IntVector& gB = gBoundaries[patches[i].name.c_str()];
-            IntVector::iterator it = find(gB.begin(),gB.end(),list[0]);
-            if(it == gB.end()) {
-                forEach(list,j)
-                    gB.push_back(list[j]);
-            }
-        }
-    }
-    /*default specified*/
-    if(!default_name.empty()) {
-        IntVector faceInB;
-        faceInB.assign(gFacets.size(),0);
-        forEachIt(Boundaries,gBoundaries,it) {
-            IntVector& gB = it->second; 
-            forEach(gB,j)
-                faceInB[gB[j]] = 1;
-        }
+    addBoundaries(gMesh,corners,patches,default_name);
     
-        IntVector& gB = gBoundaries[default_name.c_str()];
-        forEachS(gFacets,i,gMesh.mNF) {
-            if(!faceInB[i])
-                gB.push_back(i);
-        }
-    }
     /*write it*/
     gMesh.writeMesh(cout);
     return 0;
@@ -1,39 +1,108 @@
 #include <cstdarg>
+#include <cstring>
 #include <limits.h>
+#include <pthread.h>
 #include "mp.h"
+#include "threads.h"
 #include "system.h"
 
 /*statics*/
 int  MP::n_hosts;
 int  MP::host_id;
 int  MP::name_len;
+int  MP::n_nodes;
+std::vector<int> MP::host_node;
 char MP::host_name[PATH_MAX + 1];
 int  MP::_start_time = 0;
 bool MP::Terminated = false;
 bool MP::printOn = true;
+bool MP::progress = false;
+std::atomic<int> MP::n_active(0);
 char MP::workingDir[PATH_MAX + 1];
+int  Threads::n_threads = 1;
+
+/*progress thread*/
+static pthread_t progress_thread;
+static std::atomic<bool> progress_stop(false);
+static MPI_Comm progress_comm;
 
 /** Initialize MPI */
 MP::MP(int argc,char* argv[]) {
-    MPI_Init(&argc, &argv);
+    for(int i = 1;i < argc;i++) {
+        if(!strcmp(argv[i],"-progress"))
+            progress = true;
+    }
+    if(progress) {
+        int provided;
+        MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+        progress = (provided == MPI_THREAD_MULTIPLE);
+    } else {
+        MPI_Init(&argc, &argv);
+    }
     MPI_Comm_size(MPI_COMM_WORLD, &n_hosts);
     MPI_Comm_rank(MPI_COMM_WORLD, &host_id);
     MPI_Get_processor_name(host_name, &name_len);
+    
+    /*find node of each host from processor names*/
+    {
+        const int len = MPI_MAX_PROCESSOR_NAME;
+        std::vector<char> names(n_hosts * len);
+        MPI_Allgather(host_name, len, MPI_CHAR, 
+            &names[0], len, MPI_CHAR, MPI_COMM_WORLD);
+        host_node.assign(n_hosts,0);
+        n_nodes = 0;
+        for(int i = 0;i < n_hosts;i++) {
+            int j;
+            for(j = 0;j < i;j++) {
+                if(!strcmp(&names[i * len],&names[j * len]))
+                    break;
+            }
+            host_node[i] = (j < i) ? host_node[j] : n_nodes++;
+        }
+    }
     _start_time = System::get_time();
     System::pwd(workingDir,PATH_MAX + 1);
     if(host_id == 0) {
         printf("--------------------------------------------\n");
         printf("%d processes started with master on %s pid %d\n",
             n_hosts,host_name,System::get_pid());
+        if(progress)
+            printf("Communication progress thread enabled\n");
     }
     fflush(stdout);
+    if(progress) {
+        MPI_Comm_dup(MPI_COMM_WORLD, &progress_comm);
+        pthread_create(&progress_thread, NULL, progress_loop, NULL);
+    }
 }
 
 /** Finalize MPI*/
 MP::~MP() {
+    if(progress) {
+        progress_stop = true;
+        pthread_join(progress_thread, NULL);
+        MPI_Comm_free(&progress_comm);
+    }
     MPI_Finalize();
 }
 
+/** 
+Drive outstanding non-blocking communications while the main thread
+is computing. Probing on a private communicator enters the MPI progress
+engine without consuming any message.
+*/
+void* MP::progress_loop(void*) {
+    int flag;
+    while(!progress_stop) {
+        if(n_active > 0)
+            MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, progress_comm,
+                &flag, MPI_STATUS_IGNORE);
+        else
+            usleep(100);
+    }
+    return NULL;
+}
+
 /** Synchronous seend */
 void MP::send(int source,int message_id) {
     MPI_Send(MPI_BOTTOM,0,MPI_INT,source,message_id,MPI_COMM_WORLD);
@@ -1,6 +1,8 @@
 #ifndef __MP_H
 #define __MP_H
 
+#include <vector>
+#include <atomic>
 #include "mpi.h"
 #include "my_types.h"
 
@@ -32,12 +34,17 @@ public:
     ~MP();
 public:
     typedef MPI_Request REQUEST;
+    typedef MPI_Win WINDOW;
 
     static int n_hosts,host_id,name_len;
+    static int n_nodes;
+    static std::vector<int> host_node;
     static char host_name[PATH_MAX + 1];
     static int _start_time;
     static bool Terminated;
     static bool printOn;
+    static bool progress;
+    static std::atomic<int> n_active;
     static char workingDir[PATH_MAX + 1];
     static void cleanup();
     static void loop();
@@ -48,6 +55,7 @@ public:
     static void printH(const char* format,...);
     static void print(const char* format,...);
     static bool hasElapsed(const Int);
+    static void* progress_loop(void*);
 
     template <class type>
     static void recieve(type* buffer,int size,int source,int message_id) {
@@ -59,30 +67,77 @@ public:
         const int count = (size * sizeof(type) / sizeof(MPI_SCALAR));
         MPI_Send(buffer,count,MPI_SCALAR,source,message_id,MPI_COMM_WORLD);
     }
+    static MPI_Op get_op(Int op) {
+        switch(op) {
+            case OP_MAX: return MPI_MAX;
+            case OP_MIN: return MPI_MIN;
+            case OP_PROD: return MPI_PROD;
+            default: return MPI_SUM;
+        }
+    }
     template <class type>
     static void allreduce(type* sendbuf,type* recvbuf,int size, Int op) {
         const int count = (size * sizeof(type) / sizeof(MPI_SCALAR));
-        MPI_Op mpi_op;
-        switch(op) {
-            case OP_MAX: mpi_op = MPI_MAX; break;
-            case OP_MIN: mpi_op = MPI_MIN; break;
-            case OP_SUM: mpi_op = MPI_SUM; break;
-            case OP_PROD: mpi_op = MPI_PROD; break;
-        }
-        MPI_Allreduce(sendbuf,recvbuf,count,MPI_SCALAR,mpi_op,MPI_COMM_WORLD);
+        MPI_Allreduce(sendbuf,recvbuf,count,MPI_SCALAR,get_op(op),MPI_COMM_WORLD);
+    }
+    template <class type>
+    static void iallreduce(type* sendbuf,type* recvbuf,int size, Int op,void* request) {
+        const int count = (size * sizeof(type) / sizeof(MPI_SCALAR));
+        MPI_Iallreduce(sendbuf,recvbuf,count,MPI_SCALAR,get_op(op),MPI_COMM_WORLD,(MPI_Request*)request);
+        n_active++;
     }
     template <class type>
     static void irecieve(type* buffer,int size,int source,int message_id,void* request) {
         const int count = (size * sizeof(type) / sizeof(MPI_SCALAR));
         MPI_Irecv(buffer,count,MPI_SCALAR,source,message_id,MPI_COMM_WORLD,(MPI_Request*)request);
+        n_active++;
     }
     template <class type>
     static void isend(type* buffer,int size,int source,int message_id,void* request) {
         const int count = (size * sizeof(type) / sizeof(MPI_SCALAR));
         MPI_Isend(buffer,count,MPI_SCALAR,source,message_id,MPI_COMM_WORLD,(MPI_Request*)request);
+        n_active++;
+    }
+    static void irecieve(float* buffer,int size,int source,int message_id,void* request) {
+        MPI_Irecv(buffer,size,MPI_FLOAT,source,message_id,MPI_COMM_WORLD,(MPI_Request*)request);
+        n_active++;
+    }
+    static void isend(float* buffer,int size,int source,int message_id,void* request) {
+        MPI_Isend(buffer,size,MPI_FLOAT,source,message_id,MPI_COMM_WORLD,(MPI_Request*)request);
+        n_active++;
     }
     static void waitall(int count,void* request) {
         MPI_Waitall(count,(MPI_Request*)request,MPI_STATUS_IGNORE);
+        n_active -= count;
+    }
+    static bool test(void* request) {
+        int flag;
+        MPI_Test((MPI_Request*)request,&flag,MPI_STATUS_IGNORE);
+        if(flag) n_active--;
+        return flag;
+    }
+    /* one-sided communication */
+    template <class type>
+    static void win_create(type* buffer,int size,WINDOW* win) {
+        MPI_Win_create(buffer,size * sizeof(type),sizeof(type),
+            MPI_INFO_NULL,MPI_COMM_WORLD,win);
+        n_active++;
+    }
+    static void win_free(WINDOW* win) {
+        MPI_Win_free(win);
+        n_active--;
+    }
+    static void win_lock(int target,bool exclusive,WINDOW win) {
+        MPI_Win_lock(exclusive ? MPI_LOCK_EXCLUSIVE : MPI_LOCK_SHARED,
+            target,0,win);
+    }
+    static void win_unlock(int target,WINDOW win) {
+        MPI_Win_unlock(target,win);
+    }
+    template <class type>
+    static void put(type* buffer,int size,int target,int disp,WINDOW win) {
+        const int count = (size * sizeof(type) / sizeof(MPI_SCALAR));
+        MPI_Put(buffer,count,MPI_SCALAR,target,disp,count,MPI_SCALAR,win);
     }
 };
 #endif
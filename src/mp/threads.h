@@ -0,0 +1,109 @@
+#ifndef __THREADS_H
+#define __THREADS_H
+
+#ifdef _OPENMP
+#    include <omp.h>
+#endif
+#include <vector>
+#include "my_types.h"
+
+/**
+Shared memory parallelism within a processor. OpenMP keeps a persistent
+pool of threads, and loops are split statically into cache line aligned
+chunks so that a thread always touches the same part of a field.
+*/
+namespace Threads {
+    extern int n_threads;
+
+    const Int CACHE_LINE = 64;      /**< Chunks are multiples of this size */
+    const Int MIN_SIZE = 2048;      /**< Smaller loops run serially */
+
+    /** Set number of threads */
+    inline void init(int n) {
+        n_threads = (n > 1) ? n : 1;
+#ifdef _OPENMP
+        omp_set_num_threads(n_threads);
+#else
+        n_threads = 1;
+#endif
+    }
+    /** Thread id */
+    inline int id() {
+#ifdef _OPENMP
+        return omp_get_thread_num();
+#else
+        return 0;
+#endif
+    }
+    /** Number of threads in current team */
+    inline int count() {
+#ifdef _OPENMP
+        return omp_get_num_threads();
+#else
+        return 1;
+#endif
+    }
+    /** Start and end of chunk of [0,n) of the calling thread */
+    inline Int chunk(Int n,Int esize,Int& end) {
+        const int nt = count();
+        Int align = CACHE_LINE / esize;
+        if(!align) align = 1;
+        Int size = (n + nt - 1) / nt;
+        size = ((size + align - 1) / align) * align;
+        Int start = id() * size;
+        if(start > n) start = n;
+        end = start + size;
+        if(end > n) end = n;
+        return start;
+    }
+    /** Start and end of chunk of [s,e) of the calling thread */
+    inline Int chunk(Int s,Int e,Int esize,Int& end) {
+        Int start = s + chunk(e - s,esize,end);
+        end += s;
+        return start;
+    }
+}
+
+/** \name Parallel loops*/
+//@{
+#define PRAGMA_(x) _Pragma(#x)
+#ifdef _OPENMP
+#    define PARALLEL(n)                                         \
+    PRAGMA_(omp parallel if(Threads::n_threads > 1 &&           \
+                            (n) >= Threads::MIN_SIZE))
+#else
+#    define PARALLEL(n)
+#endif
+
+#define forRangeP(n,i,esize)                                    \
+    PARALLEL(n)                                                 \
+    for(Int i##_e, i = Threads::chunk(n,esize,i##_e);i < i##_e;i++)
+
+#define forRangeSP(s,e,i,esize)                                 \
+    PARALLEL((e) - (s))                                         \
+    for(Int i##_e, i = Threads::chunk(s,e,esize,i##_e);i < i##_e;i++)
+
+#define forChunkP(n,esize,s,e)                                  \
+    PARALLEL(n)                                                 \
+    for(Int e, s = Threads::chunk(n,esize,e), o_ = 1;o_;o_ = 0)
+
+#define forEachP(field,i)                                       \
+    forRangeP((field).size(),i,sizeof((field)[0]))
+
+/** Deterministic sum: partial sums of the chunks of each thread are
+    added in the order of threads */
+#define reduceP(n,esize,type,sum,i,expr) {                      \
+    std::vector<type> partial_(Threads::n_threads,type(0));     \
+    PARALLEL(n) {                                               \
+        type s_ = type(0);                                      \
+        Int i##_e, i##_s = Threads::chunk(n,esize,i##_e);       \
+        for(Int i = i##_s;i < i##_e;i++)                        \
+            s_ += expr;                                         \
+        partial_[Threads::id()] = s_;                           \
+    }                                                           \
+    for(int t_ = 0;t_ < Threads::n_threads;t_++)                \
+        sum += partial_[t_];                                    \
+}
+//@}
+
+#endif
@@ -47,9 +47,9 @@ int Prepare::probe(vector<string>& fields,Int start_index) {
         sumd += dist;                                               \
 }
 #define SUM(X) {                                                    \
-        Cell& c = gCells[X];                                        \
+        Compressed::Row c = gCellFaces[X];                          \
         forEach(c,m) {                                              \
-            Facet& f = gFacets[c[m]];                               \
+            Compressed::Row f = gFaceVertices[c[m]];                \
             forEach(f,j) {                                          \
                 ADD(gVertices[f[j]],(*it)[f[j]],1.0);               \
             }                                                       \
@@ -29,6 +29,8 @@ int main(int argc,char* argv[]) {
             work = 3;
         } else if(!strcmp(argv[i],"-refine")) {
             work = 4;
+        } else if(!strcmp(argv[i],"-renumber")) {
+            work = 5;
         } else if(!strcmp(argv[i],"-poly")) {
             Vtk::write_polyhedral = true;
         } else if(!strcmp(argv[i],"-start")) {
@@ -42,6 +44,7 @@ int main(int argc,char* argv[]) {
                       << "  -vtk        --  Convert data to VTK format\n"
                       << "  -probe      --  Probe result at specified locations\n"
                       << "  -refine     --  Refine mesh\n"
+                      << "  -renumber   --  Renumber cells and faces of mesh\n"
                       << "  -poly       --  Write VTK in polyhedral format\n"
                       << "  -start <i>  --  Start at time step <i>\n"
                       << "  -h          --  Display this message\n\n";
@@ -81,6 +84,11 @@ int main(int argc,char* argv[]) {
         Controls::enrollRefine(params);
         params.read(input);
     }
+    {
+        Util::ParamList params("renumber");
+        Controls::enrollRenumber(params);
+        params.read(input);
+    }
 
     /*switch directory*/
     if(mp.n_hosts > 1) {
@@ -106,6 +114,9 @@ int main(int argc,char* argv[]) {
     } else if(work == 4) {
         cout << "Refining grid.\n";
         Prepare::refineMesh(start_index);
+    } else if(work == 5) {
+        cout << "Renumbering grid.\n";
+        Prepare::renumberMesh(start_index);
     } else {
         cout << "Decomposing domain.\n";
         Prepare::decomposeMesh(start_index);
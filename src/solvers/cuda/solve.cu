@@ -182,8 +182,8 @@ public:
         /*fill matrix in CSR format.Diagonal element 
           is always at the start of a row */
         Int cn = 0;
-        for(ii = 0;ii < gCells.size();ii++) {
-            Cell& c = gCells[ii];
+        for(ii = 0;ii < gCellFaces.size();ii++) {
+            Compressed::Row c = gCellFaces[ii];
             for(Int j = 0;j < NP;j++) {
                 Int i = ii * NP + j;
 
@@ -4,6 +4,19 @@
  *  Solve system of linear equations iteratively
  * *********************************************************************/
 
+/**
+Component-wise dot product of two fields over internal cells.
+Partial sums of each thread are added in the order of threads.
+*/
+#define Tdot_(X,Y,type,sum) {                                       \
+    std::vector<type> partial_(Threads::n_threads,type(0));         \
+    forChunkP(Mesh::gBCSfield,sizeof(type),s,e)                     \
+        Simd::dot((const Scalar*)&X[s],(const Scalar*)&Y[s],e - s,  \
+            sizeof(type) / sizeof(Scalar),                          \
+            (Scalar*)&partial_[Threads::id()]);                     \
+    for(int t_ = 0;t_ < Threads::n_threads;t_++)                    \
+        sum += partial_[t_];                                        \
+}
 /**
 Calculate global residual
 */
@@ -14,10 +27,8 @@ Scalar getResidual(const MeshField<type,entity>& r,
     type res[2];
     res[0] = type(0);
     res[1] = type(0); 
-    for(Int i = 0;i < Mesh::gBCSfield;i++) {
-        res[0] += (r[i] * r[i]);
-        res[1] += (cF[i] * cF[i]);
-    }
+    Tdot_(r,r,type,res[0]);
+    Tdot_(cF,cF,type,res[1]);
     if(sync) {
         type global_res[2];
         MP::allreduce(res,global_res,2,MP::OP_SUM);
@@ -36,9 +47,8 @@ void SolveT(const MeshMatrix<T1,T2,T3>& M) {
     MeshField<T3,CELL> r,p,AP = T3(0);
     MeshField<T3,CELL> r1(false),p1(false),AP1(false);   
     MeshField<T1,CELL>& cF = *M.cF;
-    MeshField<T3,CELL>& buffer = AP;
     MeshField<T2,CELL> D = M.ap,iD = (T2(1) / M.ap);
-    Scalar res,ires;
+    Scalar res,ires,rswitch;
     T1 alpha,beta,o_rr = T1(0),oo_rr;
     Int iterations = 0;
     bool converged = false;
@@ -46,22 +56,23 @@ void SolveT(const MeshMatrix<T1,T2,T3>& M) {
     /****************************
      * Parallel controls
      ***************************/
-    int  end_count = 0;
     bool sync = (Controls::parallel_method == Controls::BLOCKED)
         && gInterMesh.size();
-    std::vector<bool> sent_end(gInterMesh.size(),false);
+    bool async = (Controls::parallel_method == Controls::ASYNCHRONOUS)
+        && (MP::n_hosts > 1);
+    bool reduced = sync && Controls::reduced_halo;
 
     /****************************
      * Jacobi sweep
      ***************************/
 #define JacobiSweep() {                             \
-    cF = iD * getRHS(M,sync);                       \
+    cF = iD * getRHS(M,sync,reduced);               \
 }
     /****************************
      *  Forward/backward GS sweeps
      ****************************/
 #define Sweep_(X,B,ci) {                            \
-    Cell& c = gCells[ci];                           \
+    Compressed::Row c = gCellFaces[ci];             \
     forEachLgl(ii,jj,kk) {                          \
         Int index1 = INDEX4(ci,ii,jj,kk);           \
         T3 ncF = B[index1];                         \
@@ -101,14 +112,38 @@ void SolveT(const MeshMatrix<T1,T2,T3>& M) {
             ncF * (Controls::SOR_omega);                    \
     }                                                       \
 }
+/*finite volume: one unknown per cell and face*/
+#define SweepFV_(X,B,ci) {                          \
+    Compressed::Row c = gCellFaces[ci];             \
+    T3 ncF = B[ci];                                 \
+    forEach(c,j) {                                  \
+        Int f = c[j];                               \
+        Int c1 = FO[f];                             \
+        Int c2 = FN[f];                             \
+        if(ci == c1)                                \
+            ncF += X[c2] * M.an[1][f];              \
+        else                                        \
+            ncF += X[c1] * M.an[0][f];              \
+    }                                               \
+    ncF *= iD[ci];                                  \
+    X[ci] = X[ci] * (1 - Controls::SOR_omega) +     \
+        ncF * (Controls::SOR_omega);                \
+}
+#define SweepRange(X,B,s,e) {                       \
+    if(NPMAT) {                                     \
+        for(Int ci = s;ci < e;ci++)                 \
+            Sweep_(X,B,ci);                         \
+    } else {                                        \
+        for(Int ci = s;ci < e;ci++)                 \
+            SweepFV_(X,B,ci);                       \
+    }                                               \
+}
 #define ForwardSweep(X,B) {                         \
     ASYNC_COMM<T1> comm(&X[0]);                     \
-    comm.send();                                    \
-    for(Int ci = 0;ci < gBCSI;ci++)                 \
-        Sweep_(X,B,ci);                             \
+    comm.send(reduced);                             \
+    SweepRange(X,B,0,gBCSI);                        \
     comm.recv();                                    \
-    for(Int ci = gBCSI;ci < gBCS;ci++)              \
-        Sweep_(X,B,ci);                             \
+    SweepRange(X,B,gBCSI,gBCS);                     \
 }
     /***********************************
      *  Forward/backward substitution
@@ -167,22 +202,50 @@ void SolveT(const MeshMatrix<T1,T2,T3>& M) {
         ncF *= iD[index1];                              \
         X[index1] = ncF;                                \
 }
+#define SubstituteFV_(X,B,ci,forw,tr) {             \
+    Compressed::Row c = gCellFaces[ci];             \
+    T3 ncF = B[ci];                                 \
+    forEach(c,j) {                                  \
+        Int f = c[j];                               \
+        Int c1 = FO[f];                             \
+        Int c2 = FN[f];                             \
+        if(ci == c1) {                              \
+            if(forw ? (c2 < c1) : (c1 < c2))        \
+                ncF += X[c2] * M.an[1 - tr][f];     \
+        } else {                                    \
+            if(forw ? (c1 < c2) : (c2 < c1))        \
+                ncF += X[c1] * M.an[0 + tr][f];     \
+        }                                           \
+    }                                               \
+    ncF *= iD[ci];                                  \
+    X[ci] = ncF;                                    \
+}
 #define ForwardSub(X,B,TR) {                        \
-    for(Int ci = 0;ci < gBCS;ci++)  {               \
-        Cell& c = gCells[ci];                       \
-        forEachLgl(ii,jj,kk)                        \
-            Substitute_(X,B,ci,true,TR);            \
+    if(!NPMAT) {                                    \
+        for(Int ci = 0;ci < gBCS;ci++)              \
+            SubstituteFV_(X,B,ci,true,TR);          \
+    } else {                                        \
+        for(Int ci = 0;ci < gBCS;ci++)  {           \
+            Compressed::Row c = gCellFaces[ci];     \
+            forEachLgl(ii,jj,kk)                    \
+                Substitute_(X,B,ci,true,TR);        \
+        }                                           \
     }                                               \
 }
 #define BackwardSub(X,B,TR) {                       \
-    for(Int ci = gBCS;ci-- > 0;)    {               \
-        Cell& c = gCells[ci];                       \
-        forEachLglR(ii,jj,kk)                       \
-            Substitute_(X,B,ci,false,TR);           \
+    if(!NPMAT) {                                    \
+        for(Int ci = gBCS;ci-- > 0;)                \
+            SubstituteFV_(X,B,ci,false,TR);         \
+    } else {                                        \
+        for(Int ci = gBCS;ci-- > 0;)    {           \
+            Compressed::Row c = gCellFaces[ci];     \
+            forEachLglR(ii,jj,kk)                   \
+                Substitute_(X,B,ci,false,TR);       \
+        }                                           \
     }                                               \
 }
 #define DiagSub(X,B) {                              \
-    for(Int i = 0;i < gBCSfield;i++)                \
+    forRangeP(gBCSfield,i,sizeof(T3))               \
         X[i] = B[i] * iD[i];                        \
 }
     /***********************************
@@ -208,13 +271,15 @@ void SolveT(const MeshMatrix<T1,T2,T3>& M) {
      *  SAXPY and DOT operations
      ***********************************/
 #define Taxpy(Y,I,X,alpha_) {                       \
-    for(Int i = 0;i < gBCSfield;i++)                \
-        Y[i] = I[i] + X[i] * alpha_;                \
+    const T3 a_ = alpha_;                           \
+    forChunkP(gBCSfield,sizeof(T3),s,e)             \
+        Simd::axpy((Scalar*)&Y[s],(Scalar*)&I[s],   \
+            (Scalar*)&X[s],(const Scalar*)&a_,      \
+            e - s,sizeof(T3) / sizeof(Scalar));     \
 }
 #define Tdot(X,Y,sum) {                             \
     sum = T3(0);                                    \
-    for(Int i = 0;i < gBCSfield;i++)                \
-        sum += X[i] * Y[i];                         \
+    Tdot_(X,Y,T3,sum);                              \
 }
     /***********************************
      *  Synchronized sum
@@ -261,8 +326,24 @@ void SolveT(const MeshMatrix<T1,T2,T3>& M) {
                 D *=  (2.0 / Controls::SOR_omega - 1.0);    
             } else if(Controls::Preconditioner == Controls::DILU) {
                 /*D-ILU(0) pre-conditioner*/
-                for(Int ci = 0;ci < gBCS;ci++) {
-                    Cell& c = gCells[ci];
+                if(!NPMAT) {
+                    for(Int ci = 0;ci < gBCS;ci++) {
+                        Compressed::Row c = gCellFaces[ci];
+                        forEach(c,j) {
+                            Int f = c[j];
+                            Int c1 = FO[f];
+                            Int c2 = FN[f];
+                            if(ci == c1) {
+                                if(c2 > c1) D[c2] -=
+                                (M.an[0][f] * M.an[1][f] * iD[c1]);
+                            } else {
+                                if(c1 > c2) D[c1] -=
+                                (M.an[0][f] * M.an[1][f] * iD[c2]);
+                            }
+                        }
+                    }
+                } else for(Int ci = 0;ci < gBCS;ci++) {
+                    Compressed::Row c = gCellFaces[ci];
                     forEachLgl(ii,jj,kk) {
                         Int index1 = INDEX4(ci,ii,jj,kk);
                         if(NPMAT) {
@@ -322,30 +403,14 @@ void SolveT(const MeshMatrix<T1,T2,T3>& M) {
      ***********************/
     CALC_RESID();
     ires = res;
+    rswitch = sqrt(ires * Controls::tolerance);
     /********************************************************
-    * Initialize exchange of ghost cells just once.
-    * Lower numbered processors send message to higher ones.
+    * Create windows for one-sided exchange of ghost cells 
+    * and put initial values into them.
     *********************************************************/  
-    if(!sync) {
-        end_count = gInterMesh.size();
-        forEach(gInterMesh,i) {
-            interBoundary& b = gInterMesh[i];
-            if(b.from < b.to) {
-                IntVector& f = *(b.f);
-                Int buf_size = f.size() * NPF;
-                /*send*/
-                forEach(f,j) {
-                    Int faceid = f[j];
-                    Int offset = j * NPF;
-                    for(Int n = 0; n < NPF;n++) {
-                        Int k = faceid * NPF + n;
-                        buffer[offset + n] = cF[FO[k]];
-                    }
-                }
-                MP::send(&buffer[0],buf_size,b.to,MP::FIELD);
-            }
-        }
-    }
+    ASYNC_RMA<T1> rma(async);
+    if(async)
+        rma.put(&cF[0]);
     /* **************************
      * Iterative solution
      * *************************/
@@ -367,7 +432,7 @@ void SolveT(const MeshMatrix<T1,T2,T3>& M) {
                 AP[i] = cF[i] - p[i];
         } else if(M.flags & M.SYMMETRIC) {
             /*conjugate gradient*/
-            AP = mul(M,p,sync);
+            AP = mul(M,p,sync,reduced);
             Tdot(p,AP,oo_rr);
             REDUCE(T1,oo_rr);
             alpha = sdiv(o_rr , oo_rr);
@@ -382,8 +447,8 @@ void SolveT(const MeshMatrix<T1,T2,T3>& M) {
             /*end*/
         } else {
             /* biconjugate gradient*/
-            AP = mul(M,p,sync);
-            AP1 = mult(M,p1,sync);
+            AP = mul(M,p,sync,reduced);
+            AP1 = mult(M,p1,sync,reduced);
             Tdot(p1,AP,oo_rr);
             REDUCE(T1,oo_rr);
             alpha = sdiv(o_rr , oo_rr);
@@ -407,85 +472,53 @@ void SolveT(const MeshMatrix<T1,T2,T3>& M) {
         if(res <= Controls::tolerance
             || iterations == Controls::max_iterations)
             converged = true;
+        /* ***********************************************
+        * Halo values are exchanged in single precision only
+        * for the first half (in log scale) of the reduction 
+        * of residual. The rest of the iterations, and thus the
+        * final convergence check, are done in full precision.
+        * ***********************************************/
+        if(reduced && (converged || res <= rswitch 
+            || 2 * iterations >= Controls::max_iterations)) {
+            reduced = false;
+            if(Controls::Solver == Controls::PCG) {
+                ASYNC_COMM<T1> comm(&cF[0]);
+                comm.send();
+                comm.recv();
+                CALC_RESID();
+            }
+            if(iterations < Controls::max_iterations && 
+               (Controls::Solver != Controls::PCG || res > Controls::tolerance))
+                converged = false;
+        }
+        /*put boundary values into windows of neighbors*/
+        if(async)
+            rma.put(&cF[0]);
 PROBE:
         /* **********************************************************
          * Update ghost cell values. Communication is NOT forced on 
-         * every iteration,rather a non-blocking probe is used to 
-         * process messages as they arrive.
+         * every iteration,rather values put by neighbors are used 
+         * whenever they arrive. The residual needs to be re-calculated
+         * only to restart PCG or when already converged.
          ************************************************************/
-        if(!sync) {
-            int source,message_id;
-            /*probe*/
-            while(MP::iprobe(source,message_id,MP::FIELD)
-               || MP::iprobe(source,message_id,MP::END)) {
-                /*find the boundary*/
-                Int patchi;
-                for(patchi = 0;patchi < gInterMesh.size();patchi++) {
-                    if(gInterMesh[patchi].to == (Int)source) 
-                        break;
-                }
-                /*parse message*/
-                if(message_id == MP::FIELD) {
-                    interBoundary& b = gInterMesh[patchi];
-                    IntVector& f = *(b.f);
-                    Int buf_size = f.size() * NPF;
-                    
-                    /*recieve*/
-                    MP::recieve(&buffer[0],buf_size,source,message_id);
-                    forEach(f,j) {
-                        Int faceid = f[j];
-                        Int offset = j * NPF;
-                        for(Int n = 0; n < NPF;n++) {
-                            Int k = faceid * NPF + n;
-                            cF[FN[k]] = buffer[offset + n];
-                        }
-                    }
-                    
-                    /*Re-calculate residual.*/                  
+        if(async) {
+            if(rma.get(&cF[0])) {
+                if(converged || Controls::Solver == Controls::PCG) {
                     CALC_RESID();
                     if(res > Controls::tolerance
                         && iterations < Controls::max_iterations)
                         converged = false;
-                    /* For communication to continue, processor have to send back 
-                     * something for every message recieved.*/
-                    if(converged) {
-                        /*send END marker*/
-                        if(!sent_end[patchi]) {
-                            MP::send(source,MP::END);
-                            sent_end[patchi] = true;
-                        }
-                        continue;
-                    }
-                    
-                    /*send*/
-                    forEach(f,j) {
-                        Int faceid = f[j];
-                        Int offset = j * NPF;
-                        for(Int n = 0; n < NPF;n++) {
-                            Int k = faceid * NPF + n;
-                            buffer[offset + n] = cF[FO[k]];
-                        }
-                    }
-                    MP::send(&buffer[0],buf_size,source,message_id);
-                    
-                } else if(message_id == MP::END) {
-                    /*END marker recieved*/
-                    MP::recieve(source,message_id);
-                    end_count--;
-                    if(!sent_end[patchi]) {
-                        MP::send(source,MP::END);
-                        sent_end[patchi] = true;
-                    }
                 }
             }
-        }
-        /* *****************************************
-        * Wait untill all partner processors send us
-        * an END message i.e. until end_count = 0.
-        * *****************************************/
-        if(converged) {
-            if(end_count > 0) goto PROBE;
-            else break;
+            /* *****************************************
+            * Wait untill all processors have converged
+            * *****************************************/
+            if(rma.terminated(converged)) 
+                break;
+            if(converged) 
+                goto PROBE;
+        } else if(converged) {
+            break;
         }
         /********
          * end
@@ -512,7 +545,7 @@ PROBE:
             }
         }
         MP::print("Iterations %d Initial Residual "
-        "%.5e Final Residual %.5e\n",iterations,ires,res);
+        "%.5e Final Residual %.5e\n",int(iterations),ires,res);
     }
 }
 /**
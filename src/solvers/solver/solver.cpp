@@ -57,7 +57,8 @@ int main(int argc, char* argv[]) {
         std::cout << "Usage:\n"
                   << "  ./solver <inputfile>\n"
                   << "Options:\n"
-                  << "  -h          --  Display this message\n\n";
+                  << "  -h          --  Display this message\n"
+                  << "  -progress   --  Use a thread to progress communication\n\n";
         return 0;
     } 
     ifstream input(argv[1]);
@@ -71,6 +72,11 @@ int main(int argc, char* argv[]) {
         Mesh::enroll(params);
         General::enroll(params);
         params.read(input);
+        Threads::init(Controls::n_threads);
+        Arena::init(Controls::huge_pages);
+        if(MP::printOn)
+            MP::printH("Vector kernels: %s, threads: %d\n",
+                Simd::isa(),Threads::n_threads);
     }
     /*AMR options*/
     {
@@ -114,6 +120,8 @@ int main(int argc, char* argv[]) {
         wave(input);
     }
     
+    if(MP::printOn)
+        Arena::report();
 #ifdef _DEBUG
     /*print memory usage*/
     std::cout << "====================================" << std::endl;
@@ -164,7 +172,7 @@ public:
         /*iteration number*/
         if(MP::printOn && idf == 0) {
             if(Controls::state == Controls::STEADY)
-                MP::printH("Step %d\n",i);
+                MP::printH("Step %d\n",int(i));
             else
                 MP::printH("Time %f\n",i * Controls::dt);
         }
@@ -8,8 +8,13 @@
 /** Defines double precision */
 #define __DOUBLE
 
-/** Unsigned integer type*/
+/** Unsigned integer type. Meshes with more than 2 billion
+    cells, faces or vertices need 64 bit indices (make INT64=1)*/
+#ifdef __INT64
+typedef unsigned long long Int;
+#else
 typedef unsigned int  Int;
+#endif
 
 /** Forces inlining of fucntions*/
 #ifdef _MSC_VER
@@ -0,0 +1,188 @@
+#include "simd.h"
+#include "threads.h"
+
+#ifdef _OPENMP
+#    define SIMD PRAGMA_(omp simd)
+#    define SIMD_SUM(s) PRAGMA_(omp simd reduction(+:s))
+#else
+#    define SIMD
+#    define SIMD_SUM(s)
+#endif
+
+/*one binary for all processors: clone kernels per instruction set*/
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__INTEL_COMPILER) && \
+    defined(__x86_64__) && !defined(NO_DISPATCH)
+#    define DISPATCH __attribute__((target_clones("avx512f","avx2","default")))
+#else
+#    define DISPATCH
+#endif
+
+/** Set y = a */
+DISPATCH
+void Simd::fill(Scalar* y,const Scalar a,const Int n) {
+    SIMD
+    for(Int i = 0;i < n;i++)
+        y[i] = a;
+}
+/** Set y = x */
+DISPATCH
+void Simd::copy(Scalar* y,const Scalar* x,const Int n) {
+    SIMD
+    for(Int i = 0;i < n;i++)
+        y[i] = x[i];
+}
+/** Set y += a */
+DISPATCH
+void Simd::add(Scalar* y,const Scalar a,const Int n) {
+    SIMD
+    for(Int i = 0;i < n;i++)
+        y[i] += a;
+}
+/** Set y *= a */
+DISPATCH
+void Simd::mul(Scalar* y,const Scalar a,const Int n) {
+    SIMD
+    for(Int i = 0;i < n;i++)
+        y[i] *= a;
+}
+/** y = x1 + x2 * a for n tensors of N components */
+template<Int N>
+static inline void axpy_(Scalar* y,const Scalar* x1,const Scalar* x2,
+                         const Scalar* a,const Int n) {
+    const Int B = Simd::BLOCK * N;
+    Scalar ab[B];
+    for(Int i = 0;i < B;i++)
+        ab[i] = a[i % N];
+    Int nb = (n / Simd::BLOCK) * B;
+    for(Int k = 0;k < nb;k += B) {
+        SIMD
+        for(Int i = 0;i < B;i++)
+            y[k + i] = x1[k + i] + x2[k + i] * ab[i];
+    }
+    for(Int i = nb;i < n * N;i++)
+        y[i] = x1[i] + x2[i] * ab[i - nb];
+}
+/** Component-wise sum of x * y for n tensors of N components */
+template<Int N>
+static inline void dot_(const Scalar* x,const Scalar* y,const Int n,Scalar* sum) {
+    const Int B = Simd::BLOCK * N;
+    Scalar acc[B];
+    for(Int i = 0;i < B;i++)
+        acc[i] = 0;
+    Int nb = (n / Simd::BLOCK) * B;
+    for(Int k = 0;k < nb;k += B) {
+        SIMD
+        for(Int i = 0;i < B;i++)
+            acc[i] += x[k + i] * y[k + i];
+    }
+    for(Int i = nb;i < n * N;i++)
+        acc[i - nb] += x[i] * y[i];
+    for(Int i = 0;i < B;i++)
+        sum[i % N] += acc[i];
+}
+/** Scalars need no blocking */
+template<>
+inline void dot_<1>(const Scalar* x,const Scalar* y,const Int n,Scalar* sum) {
+    Scalar s = 0;
+    SIMD_SUM(s)
+    for(Int i = 0;i < n;i++)
+        s += x[i] * y[i];
+    *sum += s;
+}
+/** Set y = x1 + x2 * a where a has one value per component */
+DISPATCH
+void Simd::axpy(Scalar* y,const Scalar* x1,const Scalar* x2,
+                const Scalar* a,const Int n,const Int N) {
+    switch(N) {
+        case 1: axpy_<1>(y,x1,x2,a,n); break;
+        case 3: axpy_<3>(y,x1,x2,a,n); break;
+        case 6: axpy_<6>(y,x1,x2,a,n); break;
+        case 9: axpy_<9>(y,x1,x2,a,n); break;
+        default:
+            for(Int i = 0;i < n * N;i++)
+                y[i] = x1[i] + x2[i] * a[i % N];
+            break;
+    }
+}
+/** Add component-wise dot product of x and y to sum */
+DISPATCH
+void Simd::dot(const Scalar* x,const Scalar* y,
+               const Int n,const Int N,Scalar* sum) {
+    switch(N) {
+        case 1: dot_<1>(x,y,n,sum); break;
+        case 3: dot_<3>(x,y,n,sum); break;
+        case 6: dot_<6>(x,y,n,sum); break;
+        case 9: dot_<9>(x,y,n,sum); break;
+        default:
+            for(Int i = 0;i < n * N;i++)
+                sum[i % N] += x[i] * y[i];
+            break;
+    }
+}
+/** y = x * a for n tensors of N components scaled by a scalar each */
+template<Int N>
+static inline void scale_(Scalar* y,const Scalar* x,const Scalar* a,const Int n) {
+    SIMD
+    for(Int i = 0;i < n;i++) {
+        for(Int j = 0;j < N;j++)
+            y[i * N + j] = x[i * N + j] * a[i];
+    }
+}
+/** Scale tensors by a scalar each */
+DISPATCH
+void Simd::scale(Scalar* y,const Scalar* x,const Scalar* a,
+                 const Int n,const Int N) {
+    switch(N) {
+        case 1: scale_<1>(y,x,a,n); break;
+        case 3: scale_<3>(y,x,a,n); break;
+        case 6: scale_<6>(y,x,a,n); break;
+        case 9: scale_<9>(y,x,a,n); break;
+        default:
+            for(Int i = 0;i < n * N;i++)
+                y[i] = x[i] * a[i / N];
+            break;
+    }
+}
+/** y = x[o] * w + x[nb] * (1 - w) for n tensors of N components */
+template<Int N>
+static inline void interp_(Scalar* y,const Scalar* x,const Int* o,const Int* nb,
+                           const Scalar* w,const Int n) {
+    SIMD
+    for(Int i = 0;i < n;i++) {
+        const Scalar* p = x + o[i] * N;
+        const Scalar* q = x + nb[i] * N;
+        for(Int j = 0;j < N;j++)
+            y[i * N + j] = p[j] * w[i] + q[j] * (1 - w[i]);
+    }
+}
+/** Interpolate tensors from two gathered locations */
+DISPATCH
+void Simd::interp(Scalar* y,const Scalar* x,const Int* o,const Int* nb,
+                  const Scalar* w,const Int n,const Int N) {
+    switch(N) {
+        case 1: interp_<1>(y,x,o,nb,w,n); break;
+        case 3: interp_<3>(y,x,o,nb,w,n); break;
+        case 6: interp_<6>(y,x,o,nb,w,n); break;
+        case 9: interp_<9>(y,x,o,nb,w,n); break;
+        default:
+            for(Int i = 0;i < n;i++) {
+                const Scalar* p = x + o[i] * N;
+                const Scalar* q = x + nb[i] * N;
+                for(Int j = 0;j < N;j++)
+                    y[i * N + j] = p[j] * w[i] + q[j] * (1 - w[i]);
+            }
+            break;
+    }
+}
+/** Instruction set used by the kernels */
+const char* Simd::isa() {
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__INTEL_COMPILER) && \
+    defined(__x86_64__) && !defined(NO_DISPATCH)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) return "avx512f";
+    if(__builtin_cpu_supports("avx2")) return "avx2";
+    return "default";
+#else
+    return "default";
+#endif
+}
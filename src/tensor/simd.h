@@ -0,0 +1,35 @@
+#ifndef __SIMD_H
+#define __SIMD_H
+
+#include "tensor.h"
+
+/**
+Vectorised kernels on arrays of scalars. A field of tensors is stored as
+contiguous tensors, so elementwise operations can run over one flat array
+of scalars. Operations that differ per component (scaling by a vector,
+component-wise dot products) work on blocks of BLOCK tensors which are
+handled as flat arrays too, so the SIMD lanes are filled regardless of
+the number of components.
+
+The kernels are compiled for several instruction sets and the best one
+supported by the processor is selected when the program is loaded.
+*/
+namespace Simd {
+    const Int BLOCK = 8;    /**< Tensors in a block */
+
+    void fill(Scalar* y,const Scalar a,const Int n);
+    void copy(Scalar* y,const Scalar* x,const Int n);
+    void add(Scalar* y,const Scalar a,const Int n);
+    void mul(Scalar* y,const Scalar a,const Int n);
+    void axpy(Scalar* y,const Scalar* x1,const Scalar* x2,
+              const Scalar* a,const Int n,const Int N);
+    void dot(const Scalar* x,const Scalar* y,
+             const Int n,const Int N,Scalar* sum);
+    void scale(Scalar* y,const Scalar* x,const Scalar* a,
+               const Int n,const Int N);
+    void interp(Scalar* y,const Scalar* x,const Int* o,const Int* nb,
+                const Scalar* w,const Int n,const Int N);
+    const char* isa();
+}
+
+#endif
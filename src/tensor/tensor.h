@@ -414,7 +414,7 @@ namespace Constants {
     enum {
         XX, YY, ZZ, XY, YZ, XZ, YX, ZY, ZX
     };
-    const Int MAX_INT = Int(1 << 31);
+    const Int MAX_INT = Int(1) << (sizeof(Int) * 8 - 1);
     const Scalar PI = Scalar(3.14159265358979323846264);
     const Scalar E  = Scalar(2.71828182845904523536028);
     const Scalar MachineEpsilon = (sizeof(Scalar) == 4) ? Scalar(1e-8) : Scalar(1e-15);
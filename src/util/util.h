@@ -81,28 +81,26 @@ bool equal(std::vector<T>& v1,std::vector<T>& v2) {
     return true;
 }
     
-/** Erase indices from a vector. It assumes the indices are already sorted */
+/** Erase indices from a vector. It assumes the indices are already sorted,
+    repeated indices are erased once. Kept elements are moved down in place
+    by swapping, so rows of nested vectors are not copied */
 template<typename T>
 void erase_indices(std::vector<T>& data, const std::vector<Int>& indicesToDelete) {
     if(indicesToDelete.size() == 0)
         return;
-        
-    std::vector<T> temp;
-    temp.reserve(data.size() - indicesToDelete.size());
-
-    typename std::vector<T>::const_iterator itBlockBegin = data.begin();
-    for(std::vector<Int>::const_iterator it = indicesToDelete.begin(); 
-        it != indicesToDelete.end(); ++ it) {
-        typename std::vector<T>::const_iterator itBlockEnd = data.begin() + *it;
-        if(itBlockBegin != itBlockEnd)
-            std::copy(itBlockBegin, itBlockEnd, std::back_inserter(temp));
-        itBlockBegin = itBlockEnd + 1;
+    
+    Int k = 0, d = 0;
+    for(Int i = 0;i < data.size();i++) {
+        if(d < indicesToDelete.size() && indicesToDelete[d] == i) {
+            while(d < indicesToDelete.size() && indicesToDelete[d] == i)
+                d++;
+            continue;
+        }
+        if(k != i)
+            std::swap(data[k],data[i]);
+        k++;
     }
-    typename std::vector<T>::const_iterator itBlockEnd = data.end();
-    if(itBlockBegin != itBlockEnd) 
-        std::copy(itBlockBegin, itBlockEnd, std::back_inserter(temp));
-
-    data = temp;
+    data.resize(k);
 }
 
 /** Compare pair using second value */
@@ -132,10 +130,13 @@ namespace Util {
 
     /** General string option list*/
     struct Option {
-        Int* val;
+        void* val;
+        Int   bytes;
         std::vector<std::string> list;
-        Option(void* v,Int N, ...) {
-            val = (Int*)v;
+        template<typename T>
+        Option(T* v,Int N, ...) {
+            val = v;
+            bytes = sizeof(T);
             std::string str;
             list.assign(N,"");
             va_list ap;
@@ -146,6 +147,15 @@ namespace Util {
             }
             va_end(ap);
         }
+        /*targets are enums or Int, which differ with 64 bit Int*/
+        void set(Int id) {
+            if(bytes == sizeof(Int)) *(Int*)val = id;
+            else *(int*)val = int(id);
+        }
+        Int get() const {
+            if(bytes == sizeof(Int)) return *(Int*)val;
+            return Int(*(int*)val);
+        }
         Int getID(std::string str) {
             forEach(list,i) {
                 if(!Util::compare(list[i],str)) 
@@ -157,18 +167,19 @@ namespace Util {
         friend std::istream& operator >> (std::istream& is, Option& p) {
             std::string str;
             is >> str;
-            *(p.val) = p.getID(str);
+            p.set(p.getID(str));
             return is;
         }
         friend std::ostream& operator << (std::ostream& os, const Option& p) {
-            os << p.list[*(p.val)];
+            os << p.list[p.get()];
             return os;
         }
     };
 
     /** Special boolean option as a YES/NO */
     struct BoolOption : public Option {
-        BoolOption(void* v) :
+        template<typename T>
+        BoolOption(T* v) :
         Option(v,2,"NO","YES")
         {
         }
@@ -11,28 +11,24 @@ bool Vtk::write_cell_value = true;
 namespace {
 
 /** Counts number of facets and vertices of cell */
-Int cell_count(Cell& c) {
-    Facet* f;
+Int cell_count(const Compressed::Row& c) {
     Int i,nFacets = c.size(),nVertices = 0,nTotal;
-    for(i = 0;i < nFacets;i++) {
-        f = &gFacets[c[i]];
-        nVertices += f->size();
-    }
+    for(i = 0;i < nFacets;i++)
+        nVertices += gFaceVertices.size(c[i]);
     nTotal = nFacets + nVertices + 2;
     return nTotal;
 }
 
 /** Writes one cell in ascii vtk format */
-void cell_vtk(std::ofstream& of, Cell& c) {
-    Facet* f;
+void cell_vtk(std::ofstream& of, const Compressed::Row& c) {
     Int i,j,nFacets = c.size(),nTotal = cell_count(c);
     /*write*/
     of << nTotal - 1 << " " << nFacets << " ";
     for(i = 0;i < nFacets;i++) {
-        f = &gFacets[c[i]];
-        of << f->size() << " ";
-        for(j = 0;j < f->size();j++) {
-            of << (*f)[j] << " ";
+        Compressed::Row f = gFaceVertices[c[i]];
+        of << f.size() << " ";
+        for(j = 0;j < f.size();j++) {
+            of << f[j] << " ";
         }
     }
     of << endl;
@@ -68,11 +64,11 @@ void Vtk::write_vtk(Int step) {
             /*polyhedral cells*/
             total = 0;
             for(i = 0;i < gBCS;i++)
-                total += cell_count(gCells[i]);
+                total += cell_count(gCellFaces[i]);
 
             of << "CELLS " << gBCS << " " << total << endl;
             for(i = 0;i < gBCS;i++)
-                cell_vtk(of,gCells[i]);
+                cell_vtk(of,gCellFaces[i]);
 
             of << "CELL_TYPES " << gBCS << endl;
             for(i = 0;i < gBCS;i++)
@@ -81,9 +77,9 @@ void Vtk::write_vtk(Int step) {
             /*hexahedral cells*/
             of << "CELLS " << gBCS << " " << gBCS * 9 << endl;
             for(i = 0;i < gBCS;i++) {
-                Cell& c = gCells[i];
-                Facet f1 = gFacets[c[0]];
-                Facet f2 = gFacets[c[1]];
+                Compressed::Row c = gCellFaces[i];
+                Compressed::Row f1 = gFaceVertices[c[0]];
+                Compressed::Row f2 = gFaceVertices[c[1]];
                 of << f1.size() + f2.size() << " ";
                 forEach(f1,j) 
                     of << f1[j] << " ";